@@ -1,6 +1,8 @@
 #version 330 core
 
-in vec2 TexCoord;
+flat in vec2 TileOrigin;
+flat in float TileSize;
+in vec2 QuadCoord;
 
 out vec4 FragColor;
 
@@ -8,5 +10,6 @@ uniform sampler2D tex;
 
 void main()
 {
-	FragColor = texture(tex, TexCoord);
+	// Faces merged by greedy meshing span several blocks, so the tile repeats once per block
+	FragColor = texture(tex, TileOrigin + fract(QuadCoord) * TileSize);
 }
\ No newline at end of file
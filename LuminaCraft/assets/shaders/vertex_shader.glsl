@@ -1,17 +1,64 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoord;
+// One FFaceInstance per instance, packed as described in FaceInstance.h
+layout (location = 0) in uvec2 aFace;
 
-out vec2 TexCoord;
+flat out vec2 TileOrigin;
+flat out float TileSize;
+out vec2 QuadCoord;
 
 uniform float texMultiplier;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// Atlas tile of each block id's top, bottom and sides, packed as column | row << 8
+uniform uvec3 blockTiles[64];
+
+// Corners of a unit face per ChunkBuildJob::EDirection
+const vec3 FaceCorners[24] = vec3[24](
+	vec3(1, 0, 0), vec3(0, 0, 0), vec3(1, 1, 0), vec3(0, 1, 0),	// North
+	vec3(0, 0, 1), vec3(1, 0, 1), vec3(0, 1, 1), vec3(1, 1, 1),	// South
+	vec3(1, 0, 1), vec3(1, 0, 0), vec3(1, 1, 1), vec3(1, 1, 0),	// East
+	vec3(0, 0, 0), vec3(0, 0, 1), vec3(0, 1, 0), vec3(0, 1, 1),	// West
+	vec3(0, 1, 1), vec3(1, 1, 1), vec3(0, 1, 0), vec3(1, 1, 0),	// Top
+	vec3(1, 0, 1), vec3(0, 0, 1), vec3(1, 0, 0), vec3(0, 0, 0)	// Bottom
+);
+
+// Corner of each of the face's two triangles' vertices
+const int TriangleCorners[6] = int[6](0, 3, 1, 0, 2, 3);
+
+// Axes a face's width and height run along per direction, the UAxis and VAxis of ChunkBuildJob's FaceQuads
+const vec3 FaceWidthAxes[6] = vec3[6](vec3(1, 0, 0), vec3(1, 0, 0), vec3(0, 0, 1), vec3(0, 0, 1), vec3(1, 0, 0), vec3(1, 0, 0));
+const vec3 FaceHeightAxes[6] = vec3[6](vec3(0, 1, 0), vec3(0, 1, 0), vec3(0, 1, 0), vec3(0, 1, 0), vec3(0, 0, 1), vec3(0, 0, 1));
+
 void main()
 {
-	gl_Position = projection * view * model * vec4(aPos, 1.0);
-	TexCoord = aTexCoord * texMultiplier;
+	vec3 cell = vec3(aFace.x & 63u, (aFace.x >> 6) & 63u, (aFace.x >> 12) & 63u);
+	uint face = (aFace.x >> 18) & 7u;
+	uint block = aFace.y & 65535u;
+	float extraWidth = float((aFace.y >> 16) & 255u);
+	float extraHeight = float(aFace.y >> 24);
+
+	// One cell deep along the normal
+	vec3 size = vec3(1.0) + FaceWidthAxes[face] * extraWidth + FaceHeightAxes[face] * extraHeight;
+	vec3 pos = cell + FaceCorners[face * 4u + uint(TriangleCorners[gl_VertexID])] * size;
+
+	uvec3 tiles = blockTiles[block];
+	uint tile = face == 4u ? tiles.x : (face == 5u ? tiles.y : tiles.z);
+
+	gl_Position = projection * view * model * vec4(pos, 1.0);
+	TileOrigin = vec2(tile & 255u, tile >> 8) * texMultiplier;
+	TileSize = texMultiplier;
+
+	// Texture axes of each face in ChunkBuildJob::EDirection order, running the way its corners are wound
+	switch (face)
+	{
+	case 0u: QuadCoord = vec2(-pos.x, pos.y); break;	// North
+	case 1u: QuadCoord = vec2(pos.x, pos.y); break;		// South
+	case 2u: QuadCoord = vec2(-pos.z, pos.y); break;	// East
+	case 3u: QuadCoord = vec2(pos.z, pos.y); break;		// West
+	case 4u: QuadCoord = vec2(pos.x, -pos.z); break;	// Top
+	default: QuadCoord = vec2(-pos.x, -pos.z); break;	// Bottom
+	}
 }
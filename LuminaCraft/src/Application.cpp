@@ -9,8 +9,10 @@
 #include <chrono>
 #include <thread>
 
+#include "Renderer/FaceInstance.h"
 #include "Renderer/Shader.h"
-#include "World\World.h"
+#include "World/World.h"
+#include "World/Block.h"
 #include "Logging/Log.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/ShaderLibrary.h"
@@ -155,6 +157,16 @@ void Application::Init()
 
 	PrimaryShader->SetFloat("texMultiplier", 0.5f);
 
+	// Chunk meshes store block ids; the vertex shader looks up each face's atlas tile here
+	static_assert(std::size(BlockDictionary) <= FFaceInstance::MaxBlockTiles, "vertex_shader.glsl's blockTiles is too short for BlockDictionary");
+	glm::uvec3 blockTiles[std::size(BlockDictionary)];
+	for (size_t block = 0; block < std::size(BlockDictionary); block++)
+	{
+		const Block& tiles = BlockDictionary[block];
+		blockTiles[block] = glm::uvec3(tiles.topMinX | tiles.topMinY << 8, tiles.bottomMinX | tiles.bottomMinY << 8, tiles.sideMinX | tiles.sideMinY << 8);
+	}
+	PrimaryShader->SetUVec3Array("blockTiles", blockTiles, static_cast<int>(std::size(BlockDictionary)));
+
 	unsigned int texture;
 	glGenTextures(1, &texture);
 	glActiveTexture(GL_TEXTURE0);
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <GLFW/glfw3.h>
-#include "World\World.h"
+#include "World/World.h"
 #include <memory>
 #include "threadpool/BS_thread_pool.hpp"
 #include "ImGui/ImGuiRenderer.h"
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Open-addressing hash map with linear probing over one contiguous slot array.
+ * Erase shifts later entries back instead of leaving tombstones, so lookups never slow down with churn.
+ *
+ * Keys and values must be default constructible and movable. Pointers and iterators are invalidated by any insert or erase.
+ */
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>>
+class TFlatHashMap
+{
+public:
+
+	using FEntry = std::pair<TKey, TValue>;
+
+	template <typename TMap, typename TEntry>
+	class TIterator
+	{
+	public:
+
+		TIterator(TMap* InMap, size_t InIndex)
+			: Map(InMap), Index(InIndex)
+		{
+			SkipEmpty();
+		}
+
+		/** The key must not be modified through the iterator */
+		TEntry& operator*() const { return Map->Entries[Index]; }
+		TEntry* operator->() const { return &Map->Entries[Index]; }
+
+		TIterator& operator++()
+		{
+			++Index;
+			SkipEmpty();
+			return *this;
+		}
+
+		bool operator==(const TIterator& other) const { return Index == other.Index; }
+
+	private:
+
+		void SkipEmpty()
+		{
+			while (Index < Map->Occupied.size() && !Map->Occupied[Index])
+			{
+				++Index;
+			}
+		}
+
+		TMap* Map;
+		size_t Index;
+	};
+
+	using FIterator = TIterator<TFlatHashMap, FEntry>;
+	using FConstIterator = TIterator<const TFlatHashMap, const FEntry>;
+
+	TFlatHashMap()
+	{
+		Rehash(MinCapacity);
+	}
+
+	FIterator begin() { return FIterator(this, 0); }
+	FIterator end() { return FIterator(this, Occupied.size()); }
+	FConstIterator begin() const { return FConstIterator(this, 0); }
+	FConstIterator end() const { return FConstIterator(this, Occupied.size()); }
+
+	/** Returns the value for key, or nullptr if it is not in the map */
+	TValue* Find(const TKey& key)
+	{
+		const size_t index = FindIndex(key);
+		return index != NotFound ? &Entries[index].second : nullptr;
+	}
+
+	const TValue* Find(const TKey& key) const
+	{
+		const size_t index = FindIndex(key);
+		return index != NotFound ? &Entries[index].second : nullptr;
+	}
+
+	bool Contains(const TKey& key) const
+	{
+		return FindIndex(key) != NotFound;
+	}
+
+	/** Inserts a value constructed from args unless key is already present. Returns the value and whether it was inserted. */
+	template <typename... TArgs>
+	std::pair<TValue*, bool> TryEmplace(const TKey& key, TArgs&&... args)
+	{
+		if (TValue* existing = Find(key))
+		{
+			return { existing, false };
+		}
+
+		// Keep the load factor at or below 3/4 so probe runs stay short
+		if ((Count + 1) * 4 > Occupied.size() * 3)
+		{
+			Rehash(Occupied.size() * 2);
+		}
+
+		size_t index = HomeIndex(key);
+		while (Occupied[index])
+		{
+			index = (index + 1) & Mask;
+		}
+
+		Entries[index] = FEntry(key, TValue(std::forward<TArgs>(args)...));
+		Occupied[index] = 1;
+		Count++;
+
+		return { &Entries[index].second, true };
+	}
+
+	TValue& operator[](const TKey& key)
+	{
+		return *TryEmplace(key).first;
+	}
+
+	/** Returns true if key was present */
+	bool Erase(const TKey& key)
+	{
+		const size_t index = FindIndex(key);
+		if (index == NotFound)
+		{
+			return false;
+		}
+
+		EraseAt(index);
+		return true;
+	}
+
+	/**
+	 * Erases every entry for which predicate(entry) is true and returns how many were erased.
+	 * Entries that are kept may be passed to the predicate more than once, so it should not have side effects on them.
+	 */
+	template <typename TPredicate>
+	size_t EraseIf(TPredicate&& predicate)
+	{
+		size_t erased = 0;
+
+		// An erase can shift a later entry into the current slot, so only advance past slots that are kept
+		for (size_t index = 0; index < Occupied.size();)
+		{
+			if (Occupied[index] && predicate(Entries[index]))
+			{
+				EraseAt(index);
+				erased++;
+			}
+			else
+			{
+				index++;
+			}
+		}
+
+		return erased;
+	}
+
+	void Clear()
+	{
+		Entries.assign(Entries.size(), FEntry());
+		Occupied.assign(Occupied.size(), 0);
+		Count = 0;
+	}
+
+	/** Grows the table so count entries fit without rehashing */
+	void Reserve(size_t count)
+	{
+		size_t capacity = MinCapacity;
+		while (capacity * 3 < count * 4)
+		{
+			capacity *= 2;
+		}
+
+		if (capacity > Occupied.size())
+		{
+			Rehash(capacity);
+		}
+	}
+
+	size_t Size() const { return Count; }
+	bool IsEmpty() const { return Count == 0; }
+
+private:
+
+	static constexpr size_t NotFound = ~size_t(0);
+	static constexpr size_t MinCapacity = 16;
+
+	size_t HomeIndex(const TKey& key) const
+	{
+		return THash()(key) & Mask;
+	}
+
+	size_t FindIndex(const TKey& key) const
+	{
+		for (size_t index = HomeIndex(key); Occupied[index]; index = (index + 1) & Mask)
+		{
+			if (Entries[index].first == key)
+			{
+				return index;
+			}
+		}
+
+		return NotFound;
+	}
+
+	void EraseAt(size_t hole)
+	{
+		// Walk the rest of the probe run and move back every entry whose home slot is at or before the hole
+		for (size_t next = (hole + 1) & Mask; Occupied[next]; next = (next + 1) & Mask)
+		{
+			const size_t home = HomeIndex(Entries[next].first);
+			if (((next - home) & Mask) >= ((next - hole) & Mask))
+			{
+				Entries[hole] = std::move(Entries[next]);
+				hole = next;
+			}
+		}
+
+		// Reset the freed slot so its value is destroyed now rather than when the slot is reused
+		Entries[hole] = FEntry();
+		Occupied[hole] = 0;
+		Count--;
+	}
+
+	void Rehash(size_t capacity)
+	{
+		std::vector<FEntry> oldEntries = std::move(Entries);
+		std::vector<uint8_t> oldOccupied = std::move(Occupied);
+
+		Entries = std::vector<FEntry>(capacity);
+		Occupied.assign(capacity, 0);
+		Mask = capacity - 1;
+		Count = 0;
+
+		for (size_t i = 0; i < oldOccupied.size(); i++)
+		{
+			if (!oldOccupied[i])
+			{
+				continue;
+			}
+
+			size_t index = HomeIndex(oldEntries[i].first);
+			while (Occupied[index])
+			{
+				index = (index + 1) & Mask;
+			}
+
+			Entries[index] = std::move(oldEntries[i]);
+			Occupied[index] = 1;
+			Count++;
+		}
+	}
+
+private:
+
+	std::vector<FEntry> Entries;
+
+	/** 1 where Entries holds a live entry */
+	std::vector<uint8_t> Occupied;
+
+	size_t Mask = 0;
+	size_t Count = 0;
+};
@@ -1,6 +1,12 @@
 ﻿#include "ImGuiRenderer.h"
+#include <algorithm>
 #include <imgui.h>
 #include "../World/Block.h"
+#include "../Renderer/MeshUploader.h"
+#include "../World/ChunkBuildJob.h"
+#include "../World/ChunkScheduler.h"
+#include "../World/ColumnCache.h"
+#include "../World/WorldGenerator.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "../Application.h"
@@ -47,7 +53,59 @@ void ImGuiRenderer::Update(double DeltaTime)
     ImGui::Text("DeltaTime: %f", DeltaTime);
     ImGui::Spacing();
     ImGui::Text("Player Position: X: %f Y: %f Z: %f", Player->GetPosition().x, Player->GetPosition().y, Player->GetPosition().z);
-    ImGui::Text("Block Type: %s", Block::BlockTypeToString(static_cast<Block::EBlockType>(World->GetBlockAtWorldPosition(Player->GetPosition()))).c_str());
+    const BlockID PlayerBlock = World->GetBlockAtWorldPosition(Player->GetPosition());
+    ImGui::Text("Block Type: %s", PlayerBlock == InvalidBlock ? "Not Loaded" : Block::BlockTypeToString(static_cast<Block::EBlockType>(PlayerBlock)).c_str());
+    ImGui::Spacing();
+    const ChunkCuller& ChunkCuller = World->GetChunkCuller();
+    ImGui::Text("Chunks: %u loaded, %u drawn, %u frustum culled, %u cave culled", World->numChunks, World->numChunksRendered, World->numChunksCulled, World->numChunksOccluded);
+    ImGui::Checkbox("Cave Culling", &World->bCaveCulling);
+    ImGui::SameLine();
+    ImGui::Text("%zu chunks reachable", World->GetChunkVisibility().GetNumReached());
+    ImGui::Checkbox("Occlusion Culling", &World->bOcclusionCulling);
+    ImGui::SameLine();
+    ImGui::Text("%u chunks hidden, %zu of %zu occluders drawn", World->numChunksDepthCulled, World->GetOcclusionBuffer().GetNumOccludersDrawn(), World->GetOcclusionBuffer().GetNumOccluders());
+    ImGui::Text("Cull Regions: %zu, %zu culled, %zu inside; %zu chunk boxes tested", ChunkCuller.GetNumRegions(), ChunkCuller.GetNumRegionsCulled(), ChunkCuller.GetNumRegionsInside(), ChunkCuller.GetNumChunksTested());
+    std::shared_ptr<ChunkScheduler> ChunkScheduler = World->GetChunkScheduler();
+    ImGui::Text("Chunk Streaming: %zu queued, %u in flight, %.1f chunks/s", ChunkScheduler->GetQueueDepth(), ChunkScheduler->GetInFlight(), ChunkScheduler->GetChunksPerSecond());
+    int MaxChunkJobs = static_cast<int>(ChunkScheduler->GetMaxInFlight());
+    if (ImGui::SliderInt("Max Chunk Jobs", &MaxChunkJobs, 1, 4 * static_cast<int>(Application::GetThreadPool()->get_thread_count())))
+    {
+        ChunkScheduler->SetMaxInFlight(static_cast<uint32_t>(MaxChunkJobs));
+    }
+    std::shared_ptr<FChunkJobStats> ChunkJobStats = World->GetChunkJobStats();
+    ImGui::Text("Wasted Chunk Jobs: %llu skipped, %llu abandoned, %llu discarded (of %llu)", (unsigned long long)ChunkJobStats->Skipped.load(), (unsigned long long)ChunkJobStats->Abandoned.load(), (unsigned long long)ChunkJobStats->Discarded.load(), (unsigned long long)ChunkScheduler->GetNumSubmitted());
+    const char* MeshingModeNames[] = { "Naive", "Greedy", "Binary", "Binary Greedy" };
+    int MeshingMode = static_cast<int>(World->GetMeshingMode());
+    if (ImGui::Combo("Meshing", &MeshingMode, MeshingModeNames, IM_ARRAYSIZE(MeshingModeNames)))
+    {
+        World->SetMeshingMode(static_cast<EMeshingMode>(MeshingMode));
+    }
+    for (int Mode = 0; Mode < static_cast<int>(EMeshingMode::Count); Mode++)
+    {
+        const FChunkJobStats::FMeshingStats& Meshing = ChunkJobStats->Meshing[Mode];
+        const double MeshedChunks = static_cast<double>(std::max<uint64_t>(Meshing.Chunks.load(), 1));
+        ImGui::Text("%s Meshing: %llu chunks, %.0f faces, %.1f us per chunk + %.1f us gathering input", MeshingModeNames[Mode], (unsigned long long)Meshing.Chunks.load(),
+                    Meshing.Faces.load() / MeshedChunks, Meshing.Microseconds.load() / MeshedChunks, Meshing.GatherMicroseconds.load() / MeshedChunks);
+    }
+    std::shared_ptr<MeshUploader> MeshUploader = World->GetMeshUploader();
+    ImGui::Text("Mesh Uploads: %zu backlog (%.2f MB), last frame %zu meshes, %.2f MB, %.3f ms", MeshUploader->GetBacklog(), MeshUploader->GetBacklogBytes() / (1024.0 * 1024.0), MeshUploader->GetLastFrameMeshes(), MeshUploader->GetLastFrameBytes() / (1024.0 * 1024.0), MeshUploader->GetLastFrameMilliseconds());
+    float UploadMegabytes = static_cast<float>(MeshUploader->GetBytesPerFrame() / (1024.0 * 1024.0));
+    if (ImGui::SliderFloat("Upload MB / Frame", &UploadMegabytes, 0.25f, 32.0f))
+    {
+        MeshUploader->SetBytesPerFrame(static_cast<size_t>(UploadMegabytes * 1024.0f * 1024.0f));
+    }
+    float UploadMilliseconds = static_cast<float>(MeshUploader->GetMillisecondsPerFrame());
+    if (ImGui::SliderFloat("Upload ms / Frame", &UploadMilliseconds, 0.1f, 16.0f))
+    {
+        MeshUploader->SetMillisecondsPerFrame(UploadMilliseconds);
+    }
+    std::shared_ptr<VoxelCache> VoxelCache = World->GetVoxelCache();
+    ImGui::Text("Voxel Cache Hit Rate: %.1f%% (%llu hits / %llu misses)", VoxelCache->GetHitRate() * 100.0f, (unsigned long long)VoxelCache->GetHits(), (unsigned long long)VoxelCache->GetMisses());
+    ImGui::Text("Voxel Cache Size: %zu chunks, %.2f MB", VoxelCache->GetNumEntries(), VoxelCache->GetBytes() / (1024.0 * 1024.0));
+    ImGui::Text("Uniform Chunks: %llu proven, %llu scanned", (unsigned long long)VoxelCache->GetNumUniformProven(), (unsigned long long)VoxelCache->GetNumUniformScanned());
+    ImGui::Text("Cave Lattice Stride: %i", World->GetWorldGenerator()->GetCaveStride());
+    std::shared_ptr<ColumnCache> ColumnCache = World->GetColumnCache();
+    ImGui::Text("Column Cache: %zu columns, %.1f%% hit rate, %.1f KB", ColumnCache->GetNumEntries(), ColumnCache->GetHitRate() * 100.0f, ColumnCache->GetBytes() / 1024.0);
     ImGui::End();
 }
 
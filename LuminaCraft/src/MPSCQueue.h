@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Unbounded lock-free multi-producer, single-consumer queue.
+ * Producers push onto an intrusive stack with one compare-exchange. The consumer takes the whole stack with a single
+ * exchange and reverses it, so items come out in push order and there is no ABA hazard, because the consumer never
+ * pops individual nodes while producers push.
+ */
+template <typename T>
+class TMPSCQueue
+{
+public:
+
+	TMPSCQueue() = default;
+	TMPSCQueue(const TMPSCQueue&) = delete;
+	TMPSCQueue& operator=(const TMPSCQueue&) = delete;
+
+	~TMPSCQueue()
+	{
+		DeleteList(Head.exchange(nullptr, std::memory_order_acquire));
+	}
+
+	/** Safe to call from any number of threads at once */
+	void Push(T value)
+	{
+		FNode* node = new FNode{ std::move(value), Head.load(std::memory_order_relaxed) };
+		while (!Head.compare_exchange_weak(node->Next, node, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	/** Calls function(value) for everything pushed so far, oldest first, and returns how many there were. Consumer thread only. */
+	template <typename TFunction>
+	size_t Drain(TFunction&& function)
+	{
+		FNode* node = Head.exchange(nullptr, std::memory_order_acquire);
+
+		// The stack is newest first
+		FNode* reversed = nullptr;
+		while (node)
+		{
+			FNode* next = node->Next;
+			node->Next = reversed;
+			reversed = node;
+			node = next;
+		}
+
+		size_t count = 0;
+		while (reversed)
+		{
+			FNode* next = reversed->Next;
+			function(std::move(reversed->Value));
+			delete reversed;
+			reversed = next;
+			count++;
+		}
+
+		return count;
+	}
+
+	bool IsEmpty() const { return Head.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+
+	struct FNode
+	{
+		T Value;
+		FNode* Next;
+	};
+
+	static void DeleteList(FNode* node)
+	{
+		while (node)
+		{
+			FNode* next = node->Next;
+			delete node;
+			node = next;
+		}
+	}
+
+private:
+
+	std::atomic<FNode*> Head = nullptr;
+};
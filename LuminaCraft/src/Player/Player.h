@@ -16,9 +16,9 @@ public:
 
     void Update(double DeltaTime);
     
-    _forceinline std::shared_ptr<Camera> GetCamera() { return m_Camera; }
-    _forceinline  std::shared_ptr<World> GetWorld() { return m_World; }
-    _forceinline glm::vec3 GetPosition() const { return Position; }
+    inline std::shared_ptr<Camera> GetCamera() { return m_Camera; }
+    inline std::shared_ptr<World> GetWorld() { return m_World; }
+    inline glm::vec3 GetPosition() const { return Position; }
     
 
 private:
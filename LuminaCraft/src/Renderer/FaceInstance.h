@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+/**
+ * One visible chunk face, drawn as an instance of six vertices that vertex_shader.glsl builds from gl_VertexID.
+ * Position holds the minimum cell's local x, y and z in bits 0-17 (6 bits each) and the face's direction in 18-20.
+ * BlockAndSize holds the block id in bits 0-15 and the face's width and height in cells, less one, in 16-23 and 24-31,
+ * measured along the axes its texture's u and v run along. The atlas tile is looked up from the block id on the GPU.
+ */
+struct FFaceInstance
+{
+	/** Length of vertex_shader.glsl's blockTiles table, so block ids past it have no tiles */
+	static constexpr int MaxBlockTiles = 64;
+
+	/** Largest chunk size a world may use, keeping every local coordinate within Position's 6-bit fields */
+	static constexpr int MaxChunkSize = 63;
+
+	FFaceInstance(uint8_t x, uint8_t y, uint8_t z, uint8_t direction, uint8_t width, uint8_t height, uint16_t block)
+	{
+		assert(x < MaxChunkSize && y < MaxChunkSize && z < MaxChunkSize && "Face cell does not fit Position's 6-bit fields");
+		assert(block < MaxBlockTiles && "Block id has no entry in vertex_shader.glsl's blockTiles");
+
+		Position = static_cast<uint32_t>(x) | static_cast<uint32_t>(y) << 6 | static_cast<uint32_t>(z) << 12 | static_cast<uint32_t>(direction) << 18;
+		BlockAndSize = static_cast<uint32_t>(block) | static_cast<uint32_t>(width - 1) << 16 | static_cast<uint32_t>(height - 1) << 24;
+	}
+
+	uint32_t Position;
+	uint32_t BlockAndSize;
+};
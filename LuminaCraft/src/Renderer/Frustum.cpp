@@ -1 +1,116 @@
 #include "Frustum.h"
+
+// Vector width is picked at compile time from the target architecture flags (/arch:AVX, -mavx, ...)
+#if defined(__AVX__)
+#define FRUSTUM_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(FRUSTUM_SIMD_AVX)
+struct FFrustumVector
+{
+    static constexpr int Width = 8;
+
+    using FFloat = __m256;
+
+    static FFloat Load(const float* p) { return _mm256_loadu_ps(p); }
+    static FFloat Set(float f) { return _mm256_set1_ps(f); }
+    static FFloat Add(FFloat a, FFloat b) { return _mm256_add_ps(a, b); }
+    static FFloat Mul(FFloat a, FFloat b) { return _mm256_mul_ps(a, b); }
+
+    /** Bit i set where lane i is negative */
+    static int NegativeMask(FFloat v) { return _mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LT_OQ)); }
+};
+#elif defined(FRUSTUM_SIMD_SSE2)
+struct FFrustumVector
+{
+    static constexpr int Width = 4;
+
+    using FFloat = __m128;
+
+    static FFloat Load(const float* p) { return _mm_loadu_ps(p); }
+    static FFloat Set(float f) { return _mm_set1_ps(f); }
+    static FFloat Add(FFloat a, FFloat b) { return _mm_add_ps(a, b); }
+    static FFloat Mul(FFloat a, FFloat b) { return _mm_mul_ps(a, b); }
+
+    /** Bit i set where lane i is negative */
+    static int NegativeMask(FFloat v) { return _mm_movemask_ps(_mm_cmplt_ps(v, _mm_setzero_ps())); }
+};
+#endif
+
+void Frustum::classifyBoxes(const FBoxesSoA& boxes, int count, EFrustumTest* results) const
+{
+    // Per plane, the box corner furthest along the normal (p) decides outside and the nearest (n) decides inside.
+    // The normal is the same for every box, so picking the corner is picking which arrays to read, not a per-lane select.
+    const float* positive[6][3];
+    const float* negative[6][3];
+    for (int i = 0; i < 6; i++)
+    {
+        const glm::vec3& normal = planes[i].normal;
+        positive[i][0] = normal.x >= 0 ? boxes.maxX : boxes.minX;
+        positive[i][1] = normal.y >= 0 ? boxes.maxY : boxes.minY;
+        positive[i][2] = normal.z >= 0 ? boxes.maxZ : boxes.minZ;
+        negative[i][0] = normal.x >= 0 ? boxes.minX : boxes.maxX;
+        negative[i][1] = normal.y >= 0 ? boxes.minY : boxes.maxY;
+        negative[i][2] = normal.z >= 0 ? boxes.minZ : boxes.maxZ;
+    }
+
+    int first = 0;
+
+#if defined(FRUSTUM_SIMD_AVX) || defined(FRUSTUM_SIMD_SSE2)
+    using V = FFrustumVector;
+
+    for (; first + V::Width <= count; first += V::Width)
+    {
+        int outsideMask = 0;
+        int intersectMask = 0;
+
+        for (int i = 0; i < 6; i++)
+        {
+            const V::FFloat nx = V::Set(planes[i].normal.x);
+            const V::FFloat ny = V::Set(planes[i].normal.y);
+            const V::FFloat nz = V::Set(planes[i].normal.z);
+            const V::FFloat d = V::Set(planes[i].distance);
+
+            const V::FFloat positiveDistance = V::Add(V::Add(V::Mul(nx, V::Load(positive[i][0] + first)), V::Mul(ny, V::Load(positive[i][1] + first))),
+                                                      V::Add(V::Mul(nz, V::Load(positive[i][2] + first)), d));
+            const V::FFloat negativeDistance = V::Add(V::Add(V::Mul(nx, V::Load(negative[i][0] + first)), V::Mul(ny, V::Load(negative[i][1] + first))),
+                                                      V::Add(V::Mul(nz, V::Load(negative[i][2] + first)), d));
+
+            outsideMask |= V::NegativeMask(positiveDistance);
+            intersectMask |= V::NegativeMask(negativeDistance);
+        }
+
+        for (int lane = 0; lane < V::Width; lane++)
+        {
+            const int bit = 1 << lane;
+            results[first + lane] = (outsideMask & bit) ? EFrustumTest::Outside : (intersectMask & bit) ? EFrustumTest::Intersecting : EFrustumTest::Inside;
+        }
+    }
+#endif
+
+    for (int box = first; box < count; box++)
+    {
+        EFrustumTest result = EFrustumTest::Inside;
+        for (int i = 0; i < 6; i++)
+        {
+            const Plane& plane = planes[i];
+            const float positiveDistance = plane.normal.x * positive[i][0][box] + plane.normal.y * positive[i][1][box] + (plane.normal.z * positive[i][2][box] + plane.distance);
+            const float negativeDistance = plane.normal.x * negative[i][0][box] + plane.normal.y * negative[i][1][box] + (plane.normal.z * negative[i][2][box] + plane.distance);
+
+            if (positiveDistance < 0)
+            {
+                result = EFrustumTest::Outside;
+                break;
+            }
+            if (negativeDistance < 0)
+            {
+                result = EFrustumTest::Intersecting;
+            }
+        }
+        results[box] = result;
+    }
+}
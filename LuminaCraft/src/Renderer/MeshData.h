@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "FaceInstance.h"
+
+/**
+ * A finished mesh's face instances in one tightly sized allocation, one per visible quad.
+ * Meshes carry no vertices or indices; the vertex shader expands each face into its two triangles.
+ */
+class MeshData
+{
+public:
+
+	MeshData() = default;
+
+	/** Copies exactly the given faces into a new blob */
+	explicit MeshData(const std::vector<FFaceInstance>& faces)
+		: NumFaces(faces.size())
+	{
+		if (NumFaces == 0)
+		{
+			return;
+		}
+
+		Bytes = std::make_unique_for_overwrite<uint8_t[]>(GetNumBytes());
+		std::memcpy(Bytes.get(), faces.data(), GetNumBytes());
+	}
+
+	/** Frees the blob once the mesh lives on the GPU; the counts stay valid for drawing */
+	void Release()
+	{
+		Bytes.reset();
+	}
+
+	const uint8_t* GetBytes() const { return Bytes.get(); }
+	const FFaceInstance* GetFaces() const { return reinterpret_cast<const FFaceInstance*>(Bytes.get()); }
+
+	size_t GetNumFaces() const { return NumFaces; }
+
+	/** Size of the blob, whether or not it has been released */
+	size_t GetNumBytes() const { return NumFaces * sizeof(FFaceInstance); }
+
+private:
+
+	std::unique_ptr<uint8_t[]> Bytes;
+	size_t NumFaces = 0;
+};
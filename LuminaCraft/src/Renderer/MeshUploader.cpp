@@ -0,0 +1,210 @@
+#include "MeshUploader.h"
+
+#include <chrono>
+#include <cstring>
+#include <glad/glad.h>
+
+#include "Renderer.h"
+
+namespace
+{
+	size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+MeshUploader::MeshUploader(size_t InBytesPerFrame, double InMillisecondsPerFrame, int InNumStagingBuffers)
+	: StagingBuffers(InNumStagingBuffers > 0 ? InNumStagingBuffers : 1), BytesPerFrame(InBytesPerFrame), MillisecondsPerFrame(InMillisecondsPerFrame)
+{
+}
+
+MeshUploader::~MeshUploader()
+{
+	for (FStagingBuffer& staging : StagingBuffers)
+	{
+		if (staging.Fence)
+		{
+			glDeleteSync(static_cast<GLsync>(staging.Fence));
+		}
+		glDeleteBuffers(1, &staging.Buffer);
+	}
+}
+
+void MeshUploader::Enqueue(std::shared_ptr<FMeshUpload> mesh)
+{
+	BacklogBytes += mesh->GetNumBytes();
+	Queue.push_back(std::move(mesh));
+}
+
+void MeshUploader::Process()
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto elapsedMilliseconds = [&startTime]
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	};
+
+	LastFrameMeshes = 0;
+	LastFrameBytes = 0;
+
+	while (!Queue.empty() && Queue.front()->bCancelled)
+	{
+		BacklogBytes -= Queue.front()->GetNumBytes();
+		Queue.pop_front();
+	}
+
+	// Overflow waits a frame rather than stalling on the GPU
+	FStagingBuffer& staging = StagingBuffers[NextStaging];
+	if (Queue.empty() || !IsStagingFree(staging))
+	{
+		LastFrameMilliseconds = elapsedMilliseconds();
+		return;
+	}
+
+	if (staging.Capacity != BytesPerFrame)
+	{
+		ResizeStaging(staging, BytesPerFrame);
+	}
+
+	// Pick this frame's meshes and copy them into the staging buffer in one mapping
+	struct FStagedMesh
+	{
+		std::shared_ptr<FMeshUpload> Mesh;
+		size_t InstanceOffset;
+		bool bStaged;
+	};
+	std::vector<FStagedMesh> batch;
+
+	glBindBuffer(GL_COPY_READ_BUFFER, staging.Buffer);
+	uint8_t* mapped = staging.Capacity > 0
+		? static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, staging.Capacity, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT))
+		: nullptr;
+
+	size_t stagingUsed = 0;
+	size_t frameBytes = 0;
+	while (!Queue.empty())
+	{
+		std::shared_ptr<FMeshUpload>& mesh = Queue.front();
+		if (mesh->bCancelled)
+		{
+			BacklogBytes -= mesh->GetNumBytes();
+			Queue.pop_front();
+			continue;
+		}
+
+		const size_t meshBytes = mesh->GetNumBytes();
+		if (!batch.empty() && (frameBytes + meshBytes > BytesPerFrame || elapsedMilliseconds() > MillisecondsPerFrame))
+		{
+			break;
+		}
+
+		const size_t instanceOffset = stagingUsed;
+		const size_t end = AlignUp(instanceOffset + meshBytes, sizeof(FFaceInstance));
+
+		const bool bStaged = mapped && end <= staging.Capacity;
+		if (bStaged)
+		{
+			std::memcpy(mapped + instanceOffset, mesh->Mesh.GetBytes(), meshBytes);
+			stagingUsed = end;
+		}
+
+		batch.push_back({ std::move(mesh), instanceOffset, bStaged });
+		frameBytes += meshBytes;
+		BacklogBytes -= meshBytes;
+		Queue.pop_front();
+	}
+
+	if (mapped)
+	{
+		glUnmapBuffer(GL_COPY_READ_BUFFER);
+	}
+
+	for (FStagedMesh& staged : batch)
+	{
+		if (staged.bStaged)
+		{
+			CreateFromStaging(*staged.Mesh, staged.InstanceOffset);
+		}
+		else
+		{
+			CreateDirect(*staged.Mesh);
+		}
+
+		// The CPU copy is no longer needed once it is on the GPU
+		staged.Mesh->Mesh.Release();
+		staged.Mesh->bUploaded = true;
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+	if (stagingUsed > 0)
+	{
+		staging.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		NextStaging = (NextStaging + 1) % StagingBuffers.size();
+	}
+
+	LastFrameMeshes = batch.size();
+	LastFrameBytes = frameBytes;
+	LastFrameMilliseconds = elapsedMilliseconds();
+}
+
+bool MeshUploader::IsStagingFree(FStagingBuffer& staging)
+{
+	if (!staging.Fence)
+	{
+		return true;
+	}
+
+	const GLenum result = glClientWaitSync(static_cast<GLsync>(staging.Fence), 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		return false;
+	}
+
+	glDeleteSync(static_cast<GLsync>(staging.Fence));
+	staging.Fence = nullptr;
+	return true;
+}
+
+void MeshUploader::ResizeStaging(FStagingBuffer& staging, size_t capacity)
+{
+	if (!staging.Buffer)
+	{
+		glGenBuffers(1, &staging.Buffer);
+	}
+
+	glBindBuffer(GL_COPY_READ_BUFFER, staging.Buffer);
+	glBufferData(GL_COPY_READ_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+	staging.Capacity = capacity;
+}
+
+void MeshUploader::CreateFromStaging(FMeshUpload& mesh, size_t instanceOffset)
+{
+	const size_t instanceBytes = mesh.Mesh.GetNumBytes();
+
+	CreateBuffers(mesh);
+
+	glBufferData(GL_ARRAY_BUFFER, instanceBytes, nullptr, GL_STATIC_DRAW);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, instanceOffset, 0, instanceBytes);
+}
+
+void MeshUploader::CreateDirect(FMeshUpload& mesh)
+{
+	CreateBuffers(mesh);
+
+	glBufferData(GL_ARRAY_BUFFER, mesh.Mesh.GetNumBytes(), mesh.Mesh.GetFaces(), GL_STATIC_DRAW);
+}
+
+void MeshUploader::CreateBuffers(FMeshUpload& mesh)
+{
+	glGenVertexArrays(1, &mesh.VAO);
+	glBindVertexArray(mesh.VAO);
+
+	glGenBuffers(1, &mesh.VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+	Renderer::SetVertexAttributes();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "MeshData.h"
+
+/**
+ * A CPU-side mesh waiting for upload. The owner keeps a reference and adopts the GPU buffers once bUploaded is set,
+ * or sets bCancelled to have the uploader skip it.
+ */
+struct FMeshUpload
+{
+	MeshData Mesh;
+
+	uint32_t VAO = 0;
+	uint32_t VBO = 0;
+
+	bool bUploaded = false;
+	bool bCancelled = false;
+
+	size_t GetNumBytes() const { return Mesh.GetNumBytes(); }
+};
+
+/**
+ * Moves finished meshes to the GPU under a per-frame budget in bytes and milliseconds, deferring the rest to later frames.
+ * Mesh data is written into one of a ring of staging buffers, one per frame in flight, and copied into each mesh's
+ * own buffers on the GPU. A fence per staging buffer keeps a frame from overwriting data the GPU has not copied yet.
+ *
+ * Main thread only.
+ */
+class MeshUploader
+{
+public:
+
+	MeshUploader(size_t InBytesPerFrame, double InMillisecondsPerFrame, int InNumStagingBuffers = 3);
+	~MeshUploader();
+
+	void Enqueue(std::shared_ptr<FMeshUpload> mesh);
+
+	/** Uploads queued meshes in order until a budget runs out. At least one mesh is uploaded per frame so large ones can't stall. */
+	void Process();
+
+	void SetBytesPerFrame(size_t InBytesPerFrame) { BytesPerFrame = InBytesPerFrame; }
+	void SetMillisecondsPerFrame(double InMillisecondsPerFrame) { MillisecondsPerFrame = InMillisecondsPerFrame; }
+	size_t GetBytesPerFrame() const { return BytesPerFrame; }
+	double GetMillisecondsPerFrame() const { return MillisecondsPerFrame; }
+
+	size_t GetBacklog() const { return Queue.size(); }
+	size_t GetBacklogBytes() const { return BacklogBytes; }
+
+	/** Stats of the last Process call */
+	size_t GetLastFrameMeshes() const { return LastFrameMeshes; }
+	size_t GetLastFrameBytes() const { return LastFrameBytes; }
+	double GetLastFrameMilliseconds() const { return LastFrameMilliseconds; }
+
+private:
+
+	struct FStagingBuffer
+	{
+		uint32_t Buffer = 0;
+		size_t Capacity = 0;
+
+		/** GLsync, null when the GPU is done with the buffer */
+		void* Fence = nullptr;
+	};
+
+	/** Returns false if the GPU is still copying out of the buffer */
+	bool IsStagingFree(FStagingBuffer& staging);
+
+	void ResizeStaging(FStagingBuffer& staging, size_t capacity);
+
+	/** Creates the mesh's VAO and VBO, filled by copying from the bound staging buffer at the given offset */
+	static void CreateFromStaging(FMeshUpload& mesh, size_t instanceOffset);
+
+	/** Creates the mesh's buffers straight from its CPU data, for meshes larger than a staging buffer */
+	static void CreateDirect(FMeshUpload& mesh);
+
+	/**
+	 * Creates the VAO and the empty instance VBO, leaving both bound, and points the per-instance face attribute at the
+	 * VBO. The caller fills the VBO with the mesh's FFaceInstances.
+	 */
+	static void CreateBuffers(FMeshUpload& mesh);
+
+private:
+
+	std::deque<std::shared_ptr<FMeshUpload>> Queue;
+	size_t BacklogBytes = 0;
+
+	std::vector<FStagingBuffer> StagingBuffers;
+	size_t NextStaging = 0;
+
+	size_t BytesPerFrame;
+	double MillisecondsPerFrame;
+
+	size_t LastFrameMeshes = 0;
+	size_t LastFrameBytes = 0;
+	double LastFrameMilliseconds = 0.0;
+};
@@ -0,0 +1,399 @@
+#include "OcclusionBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "threadpool/BS_thread_pool.hpp"
+
+// Vector width is picked at compile time from the target architecture flags (/arch:AVX, -mavx, ...)
+#if defined(__AVX__)
+#include <immintrin.h>
+
+struct FOcclusionVector
+{
+	static constexpr int Width = 8;
+
+	using FFloat = __m256;
+
+	static FFloat Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, FFloat v) { _mm256_storeu_ps(p, v); }
+	static FFloat Set(float f) { return _mm256_set1_ps(f); }
+	static FFloat Min(FFloat a, FFloat b) { return _mm256_min_ps(a, b); }
+	static FFloat Max(FFloat a, FFloat b) { return _mm256_max_ps(a, b); }
+};
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+struct FOcclusionVector
+{
+	static constexpr int Width = 4;
+
+	using FFloat = __m128;
+
+	static FFloat Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, FFloat v) { _mm_storeu_ps(p, v); }
+	static FFloat Set(float f) { return _mm_set1_ps(f); }
+	static FFloat Min(FFloat a, FFloat b) { return _mm_min_ps(a, b); }
+	static FFloat Max(FFloat a, FFloat b) { return _mm_max_ps(a, b); }
+};
+#else
+struct FOcclusionVector
+{
+	static constexpr int Width = 1;
+
+	using FFloat = float;
+
+	static FFloat Load(const float* p) { return *p; }
+	static void Store(float* p, FFloat v) { *p = v; }
+	static FFloat Set(float f) { return f; }
+	static FFloat Min(FFloat a, FFloat b) { return std::min(a, b); }
+	static FFloat Max(FFloat a, FFloat b) { return std::max(a, b); }
+};
+#endif
+
+namespace
+{
+	/** Corners closer than this are treated as crossing the near plane */
+	constexpr float MinDepth = 0.05f;
+
+	/** Empty pixels are infinitely far away */
+	constexpr float ClearDepth = FLT_MAX;
+
+	float Cross(const glm::vec2& o, const glm::vec2& a, const glm::vec2& b)
+	{
+		return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+	}
+
+	/** Counter-clockwise convex hull of the 8 points by monotone chain, dropping collinear points. Returns its size. */
+	int ConvexHull(glm::vec2* points, glm::vec2* hull)
+	{
+		std::sort(points, points + 8, [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+		int size = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			while (size >= 2 && Cross(hull[size - 2], hull[size - 1], points[i]) <= 0.0f)
+			{
+				size--;
+			}
+			hull[size++] = points[i];
+		}
+
+		const int lowerSize = size + 1;
+		for (int i = 6; i >= 0; i--)
+		{
+			while (size >= lowerSize && Cross(hull[size - 2], hull[size - 1], points[i]) <= 0.0f)
+			{
+				size--;
+			}
+			hull[size++] = points[i];
+		}
+
+		// The last point repeats the first
+		return size - 1;
+	}
+}
+
+OcclusionBuffer::OcclusionBuffer()
+	: Depth(Width * Height, ClearDepth), TileMaxDepth(TilesX * TilesY, ClearDepth)
+{
+}
+
+void OcclusionBuffer::Rasterize(const glm::mat4& viewProjection, const std::vector<FOccluderBox>& occluders, BS::thread_pool* pool)
+{
+	ViewProjection = viewProjection;
+	NumOccluders = occluders.size();
+
+	Polygons.clear();
+	for (const FOccluderBox& occluder : occluders)
+	{
+		FPolygon polygon;
+		if (SetupPolygon(occluder, &polygon))
+		{
+			Polygons.push_back(polygon);
+		}
+	}
+
+	// Clearing an empty buffer is not worth waking anyone for
+	if (!pool || Polygons.empty())
+	{
+		for (int band = 0; band < NumBands; band++)
+		{
+			RasterizeBand(band);
+		}
+		return;
+	}
+
+	struct FBandQueue
+	{
+		std::atomic<int> NextBand = 0;
+		std::atomic<int> NumDone = 0;
+	};
+
+	// Helpers share the claim counter. One that only starts once every band is claimed returns without touching the
+	// buffer, so this call can return as soon as the claimed bands are finished rather than waiting for the pool.
+	const std::shared_ptr<FBandQueue> queue = std::make_shared<FBandQueue>();
+	auto rasterizeBands = [this, queue]
+	{
+		for (int band = queue->NextBand.fetch_add(1, std::memory_order_relaxed); band < NumBands; band = queue->NextBand.fetch_add(1, std::memory_order_relaxed))
+		{
+			RasterizeBand(band);
+			queue->NumDone.fetch_add(1, std::memory_order_release);
+			queue->NumDone.notify_all();
+		}
+	};
+
+	const int numHelpers = std::min(static_cast<int>(pool->get_thread_count()), NumBands - 1);
+	for (int i = 0; i < numHelpers; i++)
+	{
+		pool->detach_task(rasterizeBands);
+	}
+
+	rasterizeBands();
+
+	int numDone = queue->NumDone.load(std::memory_order_acquire);
+	while (numDone < NumBands)
+	{
+		queue->NumDone.wait(numDone, std::memory_order_acquire);
+		numDone = queue->NumDone.load(std::memory_order_acquire);
+	}
+}
+
+bool OcclusionBuffer::IsVisible(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+{
+	glm::vec2 screen[8];
+	float depths[8];
+	if (!ProjectBox(boxMin, boxMax, screen, depths))
+	{
+		return true;
+	}
+
+	glm::vec2 screenMin = screen[0];
+	glm::vec2 screenMax = screen[0];
+	float nearest = depths[0];
+	for (int i = 1; i < 8; i++)
+	{
+		screenMin = glm::min(screenMin, screen[i]);
+		screenMax = glm::max(screenMax, screen[i]);
+		nearest = std::min(nearest, depths[i]);
+	}
+
+	// Every pixel the box touches, even partly
+	const int minX = std::max(static_cast<int>(std::floor(screenMin.x)), 0);
+	const int minY = std::max(static_cast<int>(std::floor(screenMin.y)), 0);
+	const int maxX = std::min(static_cast<int>(std::ceil(screenMax.x)) - 1, Width - 1);
+	const int maxY = std::min(static_cast<int>(std::ceil(screenMax.y)) - 1, Height - 1);
+	if (minX > maxX || minY > maxY)
+	{
+		return true;
+	}
+
+	for (int tileY = minY / TileSize; tileY <= maxY / TileSize; tileY++)
+	{
+		for (int tileX = minX / TileSize; tileX <= maxX / TileSize; tileX++)
+		{
+			// Every occluder in this tile is nearer than the box
+			if (nearest > TileMaxDepth[tileY * TilesX + tileX])
+			{
+				continue;
+			}
+
+			const int startX = std::max(minX, tileX * TileSize);
+			const int endX = std::min(maxX, tileX * TileSize + TileSize - 1);
+			const int startY = std::max(minY, tileY * TileSize);
+			const int endY = std::min(maxY, tileY * TileSize + TileSize - 1);
+			for (int y = startY; y <= endY; y++)
+			{
+				for (int x = startX; x <= endX; x++)
+				{
+					if (nearest <= Depth[y * Width + x])
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool OcclusionBuffer::ProjectBox(const glm::vec3& boxMin, const glm::vec3& boxMax, glm::vec2* screen, float* depths) const
+{
+	for (int i = 0; i < 8; i++)
+	{
+		const glm::vec4 corner((i & 1) ? boxMax.x : boxMin.x, (i & 2) ? boxMax.y : boxMin.y, (i & 4) ? boxMax.z : boxMin.z, 1.0f);
+		const glm::vec4 clip = ViewProjection * corner;
+		if (clip.w < MinDepth)
+		{
+			return false;
+		}
+
+		screen[i] = (glm::vec2(clip) / clip.w * 0.5f + 0.5f) * glm::vec2(Width, Height);
+		depths[i] = clip.w;
+	}
+
+	return true;
+}
+
+bool OcclusionBuffer::SetupPolygon(const FOccluderBox& occluder, FPolygon* polygon) const
+{
+	glm::vec2 screen[8];
+	float depths[8];
+	if (!ProjectBox(occluder.Min, occluder.Max, screen, depths))
+	{
+		return false;
+	}
+
+	// The farthest corner's depth is behind every point of the box, so anything it hides is hidden by the box
+	glm::vec2 screenMin = screen[0];
+	glm::vec2 screenMax = screen[0];
+	polygon->Depth = depths[0];
+	for (int i = 1; i < 8; i++)
+	{
+		screenMin = glm::min(screenMin, screen[i]);
+		screenMax = glm::max(screenMax, screen[i]);
+		polygon->Depth = std::max(polygon->Depth, depths[i]);
+	}
+
+	polygon->MinX = std::max(static_cast<int>(std::floor(screenMin.x)), 0);
+	polygon->MinY = std::max(static_cast<int>(std::floor(screenMin.y)), 0);
+	polygon->MaxX = std::min(static_cast<int>(std::ceil(screenMax.x)) - 1, Width - 1);
+	polygon->MaxY = std::min(static_cast<int>(std::ceil(screenMax.y)) - 1, Height - 1);
+	if (polygon->MinX > polygon->MaxX || polygon->MinY > polygon->MaxY)
+	{
+		return false;
+	}
+
+	glm::vec2 hull[16];
+	polygon->NumEdges = ConvexHull(screen, hull);
+	if (polygon->NumEdges < 3)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < polygon->NumEdges; i++)
+	{
+		const glm::vec2& from = hull[i];
+		const glm::vec2& to = hull[(i + 1) % polygon->NumEdges];
+
+		// Inside is to the left of each counter-clockwise edge. Moving the edge in by half a pixel's extent along its
+		// normal makes the test at a pixel centre pass only if the whole pixel is inside.
+		const float a = from.y - to.y;
+		const float b = to.x - from.x;
+		polygon->EdgeA[i] = a;
+		polygon->EdgeB[i] = b;
+		polygon->EdgeC[i] = -(a * from.x + b * from.y) - 0.5f * (std::abs(a) + std::abs(b));
+	}
+
+	return true;
+}
+
+void OcclusionBuffer::RasterizeBand(int band)
+{
+	using V = FOcclusionVector;
+
+	const int bandMinY = band * BandHeight;
+	const int bandMaxY = bandMinY + BandHeight - 1;
+	const V::FFloat clearDepth = V::Set(ClearDepth);
+	for (float* pixel = Depth.data() + bandMinY * Width; pixel < Depth.data() + (bandMaxY + 1) * Width; pixel += V::Width)
+	{
+		V::Store(pixel, clearDepth);
+	}
+
+	for (const FPolygon& polygon : Polygons)
+	{
+		const int minY = std::max(polygon.MinY, bandMinY);
+		const int maxY = std::min(polygon.MaxY, bandMaxY);
+		const V::FFloat polygonDepth = V::Set(polygon.Depth);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			// A convex polygon covers one span per row. Each edge bounds the span on the side its function grows towards.
+			const float pixelY = y + 0.5f;
+			float spanMin = static_cast<float>(polygon.MinX);
+			float spanMax = static_cast<float>(polygon.MaxX);
+			for (int i = 0; i < polygon.NumEdges; i++)
+			{
+				const float a = polygon.EdgeA[i];
+				const float rowValue = polygon.EdgeB[i] * pixelY + polygon.EdgeC[i];
+				if (a > 0.0f)
+				{
+					spanMin = std::max(spanMin, std::ceil(-rowValue / a - 0.5f));
+				}
+				else if (a < 0.0f)
+				{
+					spanMax = std::min(spanMax, std::floor(-rowValue / a - 0.5f));
+				}
+				else if (rowValue < 0.0f)
+				{
+					spanMax = spanMin - 1.0f;
+				}
+			}
+
+			if (spanMin > spanMax)
+			{
+				continue;
+			}
+
+			float* row = Depth.data() + y * Width;
+			int x = static_cast<int>(spanMin);
+			const int endX = static_cast<int>(spanMax) + 1;
+			for (; x < endX && x % V::Width != 0; x++)
+			{
+				row[x] = std::min(row[x], polygon.Depth);
+			}
+			for (; x + V::Width <= endX; x += V::Width)
+			{
+				V::Store(row + x, V::Min(V::Load(row + x), polygonDepth));
+			}
+			for (; x < endX; x++)
+			{
+				row[x] = std::min(row[x], polygon.Depth);
+			}
+		}
+	}
+
+	for (int tileY = bandMinY / TileSize; tileY <= bandMaxY / TileSize; tileY++)
+	{
+		for (int tileX = 0; tileX < TilesX; tileX++)
+		{
+			V::FFloat tileMax = V::Set(0.0f);
+			for (int y = tileY * TileSize; y < (tileY + 1) * TileSize; y++)
+			{
+				const float* row = Depth.data() + y * Width + tileX * TileSize;
+				for (int x = 0; x < TileSize; x += V::Width)
+				{
+					tileMax = V::Max(tileMax, V::Load(row + x));
+				}
+			}
+
+			float lanes[V::Width];
+			V::Store(lanes, tileMax);
+			TileMaxDepth[tileY * TilesX + tileX] = *std::max_element(lanes, lanes + V::Width);
+		}
+	}
+}
+
+bool OcclusionBuffer::SelfTest(BS::thread_pool* pool)
+{
+	// Camera at the origin looking down -z at a 10x10 wall 10 units away
+	const glm::mat4 viewProjection = glm::perspective(glm::radians(70.0f), 2.0f, 0.1f, 1000.0f) * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const std::vector<FOccluderBox> occluders = { { glm::vec3(-5.0f, -5.0f, -11.0f), glm::vec3(5.0f, 5.0f, -10.0f) } };
+
+	OcclusionBuffer singleThreaded;
+	singleThreaded.Rasterize(viewProjection, occluders, nullptr);
+
+	OcclusionBuffer pooled;
+	pooled.Rasterize(viewProjection, occluders, pool);
+
+	return singleThreaded.Depth == pooled.Depth && singleThreaded.TileMaxDepth == pooled.TileMaxDepth &&
+		   !singleThreaded.IsVisible(glm::vec3(-2.0f, -2.0f, -30.0f), glm::vec3(2.0f, 2.0f, -26.0f)) &&	// Straight behind the wall
+		   singleThreaded.IsVisible(glm::vec3(-2.0f, -2.0f, -6.0f), glm::vec3(2.0f, 2.0f, -4.0f)) &&	// In front of the wall
+		   singleThreaded.IsVisible(glm::vec3(10.0f, -1.0f, -30.0f), glm::vec3(14.0f, 1.0f, -26.0f)) &&	// Behind, but past its edge
+		   singleThreaded.IsVisible(glm::vec3(-4.0f, -4.0f, -10.5f), glm::vec3(4.0f, 4.0f, -9.5f));		// Inside the wall's front half
+}
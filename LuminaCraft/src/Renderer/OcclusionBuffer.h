@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace BS
+{
+	class thread_pool;
+}
+
+/** World-space box that is solid all the way through, so it hides everything behind it */
+struct FOccluderBox
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+};
+
+/**
+ * Small software depth buffer for occlusion culling on the CPU.
+ * Occluder boxes are drawn as their screen-space silhouettes at the depth of their farthest corner, covering only
+ * pixels the silhouette covers completely, so the buffer never claims more is hidden than really is. Each 8x8 tile
+ * also keeps the farthest depth among its pixels, letting most box tests finish without reading single pixels.
+ *
+ * Depth is view distance (clip w). Rasterising splits the screen into bands of rows. The calling thread and any free pool
+ * workers claim bands until all are done, so the result does not depend on how many threads helped.
+ *
+ * Main thread only, apart from the helpers Rasterize starts itself.
+ */
+class OcclusionBuffer
+{
+public:
+
+	static constexpr int Width = 256;
+	static constexpr int Height = 128;
+	static constexpr int TileSize = 8;
+	static constexpr int BandHeight = 16;
+
+	OcclusionBuffer();
+
+	/** Clears the buffer and draws occluders as seen through viewProjection. pool may be null to rasterise on this thread only. */
+	void Rasterize(const glm::mat4& viewProjection, const std::vector<FOccluderBox>& occluders, BS::thread_pool* pool);
+
+	/** False only if every pixel the box could cover holds an occluder nearer than the box's nearest corner */
+	bool IsVisible(const glm::vec3& boxMin, const glm::vec3& boxMax) const;
+
+	/** Renders a fixed scene and checks known visibility results and that pool and single-threaded output match */
+	static bool SelfTest(BS::thread_pool* pool);
+
+	/** Stats of the last Rasterize call */
+	size_t GetNumOccluders() const { return NumOccluders; }
+	size_t GetNumOccludersDrawn() const { return Polygons.size(); }
+
+private:
+
+	static constexpr int MaxPolygonVertices = 8;
+	static constexpr int TilesX = Width / TileSize;
+	static constexpr int TilesY = Height / TileSize;
+	static constexpr int NumBands = Height / BandHeight;
+
+	/** Convex screen-space silhouette of one occluder, as edge functions that are >= 0 on pixels it fully covers */
+	struct FPolygon
+	{
+		float EdgeA[MaxPolygonVertices];
+		float EdgeB[MaxPolygonVertices];
+		float EdgeC[MaxPolygonVertices];
+		int NumEdges;
+
+		int MinX, MinY, MaxX, MaxY;
+		float Depth;
+	};
+
+	/** Projects a box's corners to pixel coordinates and view depth. False if any corner is at or behind the near plane. */
+	bool ProjectBox(const glm::vec3& boxMin, const glm::vec3& boxMax, glm::vec2* screen, float* depths) const;
+
+	/** Builds the silhouette of an occluder. False if it covers no pixel. */
+	bool SetupPolygon(const FOccluderBox& occluder, FPolygon* polygon) const;
+
+	/** Draws every polygon into the rows of one band and fills the band's tiles */
+	void RasterizeBand(int band);
+
+private:
+
+	glm::mat4 ViewProjection = glm::mat4(1.0f);
+
+	std::vector<float> Depth;
+	std::vector<float> TileMaxDepth;
+
+	std::vector<FPolygon> Polygons;
+	size_t NumOccluders = 0;
+};
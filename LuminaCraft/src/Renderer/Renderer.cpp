@@ -3,7 +3,7 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.inl>
 
-#include "Vertex.h"
+#include "FaceInstance.h"
 #include "../Logging/Log.h"
 #include "../Application.h"
 
@@ -25,36 +25,24 @@ void Renderer::Init()
 	LOG_INFO("Renderer Initialized");
 }
 
-void Renderer::CreateBuffers(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, uint32_t& VAO, uint32_t& VBO, uint32_t& EBO)
+void Renderer::SetVertexAttributes()
 {
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-	
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(Vertex), Vertices.data(), GL_STATIC_DRAW);
-	
-	glVertexAttribPointer(0, 3, GL_BYTE, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, posX)));
+	glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(FFaceInstance), (void*)(offsetof(FFaceInstance, Position)));
+	glVertexAttribDivisor(0, 1);
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_BYTE, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, texGridX)));
-	glEnableVertexAttribArray(1);
-	
-	glGenBuffers(1, &EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(uint32_t), Indices.data(), GL_STATIC_DRAW);
 }
 
-void Renderer::DrawIndexed(uint32_t modelLoc, const glm::mat4& model, uint32_t VAO, int Count)
+void Renderer::DrawFaces(uint32_t modelLoc, const glm::mat4& model, uint32_t VAO, int numFaces)
 {
-	Submit([modelLoc, model, VAO, Count]
+	Submit([modelLoc, model, VAO, numFaces]
 	{
 		glBindVertexArray(VAO);
 		
 		// Pass the model matrix to the shader
 		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 		
-		// Draw the chunk using the indices
-		glDrawElements(GL_TRIANGLES, Count, GL_UNSIGNED_INT, 0);
+		// Two triangles per face instance
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, numFaces);
 	});
 }
 
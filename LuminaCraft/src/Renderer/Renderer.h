@@ -6,8 +6,6 @@
 #include <glm/fwd.hpp>
 
 
-struct Vertex;
-
 class Renderer
 {
 public:
@@ -17,8 +15,11 @@ public:
 
 	static void Init();
 	
-	static void CreateBuffers(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices, uint32_t& VAO, uint32_t& VBO, uint32_t& EBO);
-	static void DrawIndexed(uint32_t modelLoc, const glm::mat4& model, uint32_t VAO, int Count);
+	/** Describes FFaceInstance to the bound VAO as a per-instance attribute, reading from the bound GL_ARRAY_BUFFER */
+	static void SetVertexAttributes();
+
+	/** Draws numFaces face instances, six vertices each, which the vertex shader places from the instance's FFaceInstance */
+	static void DrawFaces(uint32_t modelLoc, const glm::mat4& model, uint32_t VAO, int numFaces);
 
 	// Submit rendering commands to the queue
 	static void Submit(const std::function<void()>& RenderCommand);
@@ -34,6 +35,7 @@ private:
 private:
 	
 	std::queue<std::function<void()>> RenderQueue;
+
 	static std::shared_ptr<Renderer> s_Renderer;
 
 };
@@ -1,6 +1,7 @@
 #include "Shader.h"
 
 #include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
 
 #include <fstream>
 #include <sstream>
@@ -99,4 +100,8 @@ void Shader::SetInt(const std::string& name, int value) const
 void Shader::SetFloat(const std::string& name, float value) const
 {
 	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+}
+void Shader::SetUVec3Array(const std::string& name, const glm::uvec3* values, int count) const
+{
+	glUniform3uiv(glGetUniformLocation(ID, name.c_str()), count, glm::value_ptr(values[0]));
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <glm/fwd.hpp>
 
 class Shader
 {
@@ -12,6 +13,7 @@ public:
 
 	void SetInt(const std::string& name, int value) const;
 	void SetFloat(const std::string& name, float value) const;
+	void SetUVec3Array(const std::string& name, const glm::uvec3* values, int count) const;
 
 	
 	unsigned int GetProgramID() const { return ID; }
@@ -3,6 +3,9 @@
 #include <cstdint>
 #include <string>
 
+// Block id as stored in chunk volumes; wider than EBlockType so new block types are not capped at 256
+using BlockID = uint16_t;
+
 // Block Structure Declaration
 struct Block
 {
@@ -0,0 +1,167 @@
+#include "BlockStorage.h"
+
+#include <algorithm>
+#include <bit>
+
+BlockStorage::BlockStorage(size_t InNumVoxels, BlockID InFill)
+	: NumVoxels(InNumVoxels), Palette{ InFill }
+{
+}
+
+BlockStorage::BlockStorage(std::span<const BlockID> blocks)
+	: NumVoxels(blocks.size())
+{
+	// Direct id -> palette slot table, reused per thread and reset only for the ids this volume touched
+	thread_local std::vector<uint32_t> paletteIndex(UINT16_MAX + 1, UINT32_MAX);
+
+	for (BlockID block : blocks)
+	{
+		if (paletteIndex[block] == UINT32_MAX)
+		{
+			paletteIndex[block] = static_cast<uint32_t>(Palette.size());
+			Palette.push_back(block);
+		}
+	}
+
+	if (Palette.empty())
+	{
+		Palette.push_back(0);
+	}
+
+	Repack(GetBitsForPaletteSize(Palette.size()));
+
+	if (BitsPerVoxel > 0)
+	{
+		// Fill whole words at once; Repack left them zeroed
+		const uint32_t* slots = paletteIndex.data();
+		const size_t voxelsPerWord = VoxelsPerWordMask + 1;
+
+		for (size_t w = 0, first = 0; w < Words.size(); w++, first += voxelsPerWord)
+		{
+			const size_t count = std::min(voxelsPerWord, NumVoxels - first);
+
+			uint64_t word = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				word |= static_cast<uint64_t>(slots[blocks[first + i]]) << (i * BitsPerVoxel);
+			}
+			Words[w] = word;
+		}
+	}
+
+	for (BlockID block : Palette)
+	{
+		paletteIndex[block] = UINT32_MAX;
+	}
+}
+
+void BlockStorage::Set(size_t index, BlockID block)
+{
+	auto it = std::find(Palette.begin(), Palette.end(), block);
+	const uint32_t paletteIndex = static_cast<uint32_t>(it - Palette.begin());
+
+	if (it == Palette.end())
+	{
+		Palette.push_back(block);
+
+		const int requiredBits = GetBitsForPaletteSize(Palette.size());
+		if (requiredBits != BitsPerVoxel)
+		{
+			Repack(requiredBits);
+		}
+	}
+
+	if (BitsPerVoxel > 0)
+	{
+		SetPaletteIndex(index, paletteIndex);
+	}
+}
+
+void BlockStorage::Decode(std::span<BlockID> out) const
+{
+	if (BitsPerVoxel == 0)
+	{
+		std::fill(out.begin(), out.begin() + NumVoxels, Palette[0]);
+		return;
+	}
+
+	// Unpack a whole word at a time rather than recomputing the word and shift per voxel
+	const size_t voxelsPerWord = VoxelsPerWordMask + 1;
+	BlockID* dest = out.data();
+	size_t remaining = NumVoxels;
+
+	for (uint64_t word : Words)
+	{
+		const size_t count = std::min(voxelsPerWord, remaining);
+		for (size_t i = 0; i < count; i++)
+		{
+			*dest++ = Palette[word & IndexMask];
+			word >>= BitsPerVoxel;
+		}
+		remaining -= count;
+	}
+}
+
+size_t BlockStorage::GetMemoryUsage() const
+{
+	return sizeof(*this) + Palette.capacity() * sizeof(BlockID) + Words.capacity() * sizeof(uint64_t);
+}
+
+int BlockStorage::GetBitsForPaletteSize(size_t paletteSize)
+{
+	if (paletteSize <= 1)	return 0;
+	if (paletteSize <= 2)	return 1;
+	if (paletteSize <= 4)	return 2;
+	if (paletteSize <= 16)	return 4;
+	if (paletteSize <= 256)	return 8;
+	return 16;
+}
+
+void BlockStorage::Repack(int newBitsPerVoxel)
+{
+	std::vector<uint64_t> oldWords = std::move(Words);
+	const int oldBitsPerVoxel = BitsPerVoxel;
+	const uint32_t oldShift = VoxelsPerWordShift;
+	const uint64_t oldMask = VoxelsPerWordMask;
+	const uint64_t oldIndexMask = IndexMask;
+
+	BitsPerVoxel = newBitsPerVoxel;
+	Words.clear();
+
+	if (BitsPerVoxel == 0)
+	{
+		VoxelsPerWordShift = 0;
+		VoxelsPerWordMask = 0;
+		IndexMask = 0;
+		return;
+	}
+
+	const uint32_t voxelsPerWord = 64 / BitsPerVoxel;
+	VoxelsPerWordShift = static_cast<uint32_t>(std::countr_zero(voxelsPerWord));
+	VoxelsPerWordMask = voxelsPerWord - 1;
+	IndexMask = (uint64_t(1) << BitsPerVoxel) - 1;
+
+	Words.assign((NumVoxels + voxelsPerWord - 1) / voxelsPerWord, 0);
+
+	// Palette index 0 is all-zero bits, so a volume coming from 0 bits per voxel is already correct
+	if (oldBitsPerVoxel == 0)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < NumVoxels; i++)
+	{
+		const uint64_t word = oldWords[i >> oldShift];
+		const uint32_t shift = static_cast<uint32_t>(i & oldMask) * oldBitsPerVoxel;
+
+		SetPaletteIndex(i, static_cast<uint32_t>((word >> shift) & oldIndexMask));
+	}
+}
+
+void BlockStorage::SetPaletteIndex(size_t index, uint32_t paletteIndex)
+{
+	uint64_t& word = Words[index >> VoxelsPerWordShift];
+	const uint32_t shift = static_cast<uint32_t>(index & VoxelsPerWordMask) * BitsPerVoxel;
+
+	word = (word & ~(IndexMask << shift)) | (static_cast<uint64_t>(paletteIndex) << shift);
+}
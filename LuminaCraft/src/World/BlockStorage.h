@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Block.h"
+
+/** Returned by block lookups outside any loaded volume. Not a real block: callers must check for it before using the id. */
+constexpr BlockID InvalidBlock = 0xFFFF;
+
+/**
+ * Palette-compressed block volume. Each voxel stores an index into a local palette of block ids, packed at
+ * 0, 1, 2, 4, 8 or 16 bits depending on how many distinct ids the volume holds. Widths are powers of two so an
+ * index never straddles a 64-bit word.
+ *
+ * Writing an id that is not in the palette grows it and repacks to the next width when needed. Ids are never
+ * removed from the palette, so a volume only shrinks again when it is rebuilt from decoded blocks.
+ */
+class BlockStorage
+{
+public:
+
+	/** A volume of numVoxels copies of one block, stored without any per-voxel data */
+	BlockStorage(size_t InNumVoxels, BlockID InFill = 0);
+
+	/** Builds the palette from the distinct ids in blocks and packs them at the narrowest width that fits */
+	BlockStorage(std::span<const BlockID> blocks);
+
+	BlockID Get(size_t index) const
+	{
+		if (BitsPerVoxel == 0)
+		{
+			return Palette[0];
+		}
+
+		const uint64_t word = Words[index >> VoxelsPerWordShift];
+		const uint32_t shift = static_cast<uint32_t>(index & VoxelsPerWordMask) * BitsPerVoxel;
+
+		return Palette[(word >> shift) & IndexMask];
+	}
+
+	void Set(size_t index, BlockID block);
+
+	/** Writes every voxel to out, which must hold GetNumVoxels() ids */
+	void Decode(std::span<BlockID> out) const;
+
+	size_t GetNumVoxels() const { return NumVoxels; }
+	int GetBitsPerVoxel() const { return BitsPerVoxel; }
+	size_t GetPaletteSize() const { return Palette.size(); }
+
+	/** True if the whole volume is one block, which is then Get(0) */
+	bool IsUniform() const { return BitsPerVoxel == 0; }
+
+	/** Heap and inline bytes held by this volume */
+	size_t GetMemoryUsage() const;
+
+private:
+
+	/** Narrowest supported width that can index a palette of the given size */
+	static int GetBitsForPaletteSize(size_t paletteSize);
+
+	/** Re-encodes every voxel at a new width, keeping palette indices */
+	void Repack(int newBitsPerVoxel);
+
+	void SetPaletteIndex(size_t index, uint32_t paletteIndex);
+
+private:
+
+	size_t NumVoxels;
+
+	std::vector<BlockID> Palette;
+	std::vector<uint64_t> Words;
+
+	int BitsPerVoxel = 0;
+	uint32_t VoxelsPerWordShift = 0;
+	uint64_t VoxelsPerWordMask = 0;
+	uint64_t IndexMask = 0;
+};
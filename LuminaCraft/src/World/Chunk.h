@@ -1,52 +1,75 @@
 #pragma once
 
-#include <future>
-#include <vector>
-#include "../Renderer/Vertex.h"
+#include <memory>
+#include "ChunkVisibility.h"
+#include "VoxelCache.h"
 #include <glm/glm.hpp>
 
-struct Block;
+class World;
+class ChunkBuildJob;
+class MeshUploader;
+struct FMeshUpload;
 
 
 class Chunk
 {
 public:
 
-	enum class EDirection { North, South, East, West, Top, Bottom };
+	/** Submits the chunk's generation and meshing job to the thread pool */
+	Chunk(uint8_t chunkSize, glm::ivec3 chunkPos, World* InWorld);
 
-	
-	Chunk(uint8_t chunkSize, glm::ivec3 chunkPos);
+	/** Cancels the build job if it hasn't been picked up yet; the job keeps its own data alive until it stops */
 	~Chunk();
 
-	void GenerateChunk();
+	/**
+	 * Takes the results of a finished build job drained from the completion queue and marks the chunk ready.
+	 * The mesh is queued on the uploader and drawn from the first frame after it reaches the GPU.
+	 * Returns false if the job is not this chunk's current one, e.g. it belonged to an earlier chunk at the same position.
+	 */
+	bool FinishBuild(const std::shared_ptr<ChunkBuildJob>& job, MeshUploader& uploader);
+
 	void Render(int modelLoc);
 
-	bool IsFaceVisible(int x, int y, int z, const std::vector<uint8_t>& blockData, const std::vector<uint8_t>& adjacentData, EDirection direction, int chunkSize);
+	/** Which of the chunk's faces see each other through its air. Every face until the chunk is built. */
+	const FChunkConnectivity& GetConnectivity() const { return Connectivity; }
+
+	/** Solid boxes that hide what is behind the chunk. None until the chunk is built. */
+	const FChunkOccluders& GetOccluders() const { return Occluders; }
 
-	void GenerateFace(int x, int y, int z, const Block& block, const std::vector<uint8_t>& adjacentData, unsigned int& currentVertex, EDirection direction);
-	void AddFaceVertices(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3, float x4, float y4, float z4, float uMin, float vMin, float uMax, float vMax, unsigned int& currentVertex);
-	uint8_t GetBlockAtPosition(glm::ivec3 Pos) const;
+	/** InvalidBlock if Pos is outside the chunk or the chunk has not been built yet */
+	BlockID GetBlockAtPosition(glm::ivec3 Pos) const;
+
+	/** Copies the shared generated volume on the first edit, then writes in place. Does not rebuild the mesh. */
+	bool SetBlockAtPosition(glm::ivec3 Pos, BlockID block);
 
 	static glm::ivec3 WorldToChunkCoords(const glm::vec3& worldPosition, uint8_t chunkSize);
 	static glm::vec3 WorldToLocalChunkCoords(const glm::vec3& worldPosition, const glm::ivec3& chunkPos, uint8_t chunkSize);
 
 public:
 	
-	std::vector<uint8_t> BlockData;
+	VoxelData BlockData;
 	glm::ivec3 chunkPos;
 	
 	bool ready;
-	std::future<void> Future;
 
 
 private:
+
+	/** Owned jointly with the pool task, released once the chunk takes its results */
+	std::shared_ptr<ChunkBuildJob> BuildJob;
+
+	/** Mesh waiting in the uploader's queue; its buffers are adopted once it is uploaded */
+	std::shared_ptr<FMeshUpload> PendingMesh;
 	
-	uint32_t vao, vbo, ebo;
+	/** This chunk's own copy of its volume once it has been edited; BlockData points at it from then on */
+	std::shared_ptr<BlockStorage> EditedBlockData;
+
+	FChunkConnectivity Connectivity;
+	FChunkOccluders Occluders;
+
+	uint32_t vao, vbo;
 	int32_t chunkSize;
-	uint64_t numTriangles;
+	uint64_t numFaces;
 	
 	glm::ivec3 worldPos;
-
-	std::vector<Vertex> vertices;
-	std::vector<unsigned int> indices;
 };
\ No newline at end of file
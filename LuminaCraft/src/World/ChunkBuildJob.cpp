@@ -0,0 +1,708 @@
+#include "ChunkBuildJob.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+#include "Block.h"
+#include "ChunkVolume.h"
+#include "ColumnCache.h"
+#include "WorldGenerator.h"
+
+namespace
+{
+	/** The axes a face's texture's u and v run along, which its width and height are measured along, and the direction it faces */
+	struct FFaceQuad
+	{
+		int UAxis;
+		int VAxis;
+		glm::ivec3 Normal;
+	};
+
+	/** Indexed by ChunkBuildJob::EDirection. vertex_shader.glsl winds each face's corners to match. */
+	const FFaceQuad FaceQuads[6] =
+	{
+		{ 0, 1, { 0, 0, -1 } },	// North
+		{ 0, 1, { 0, 0, 1 } },	// South
+		{ 2, 1, { 1, 0, 0 } },	// East
+		{ 2, 1, { -1, 0, 0 } },	// West
+		{ 0, 2, { 0, 1, 0 } },	// Top
+		{ 0, 2, { 0, -1, 0 } }	// Bottom
+	};
+
+	/** Widest chunk whose padded voxel rows fit the bitmask meshers' 64-bit words */
+	constexpr int MaxBinaryChunkSize = 62;
+
+	/** The lowest count bits set */
+	uint64_t LowBits(int count)
+	{
+		return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+	}
+
+	/**
+	 * Bit per solid voxel of each row of a padded volume along an axis, in padded coordinates p = local + 1:
+	 * alongX[py * size + pz] holds bit px, alongY[px * size + pz] bit py and alongZ[px * size + py] bit pz.
+	 * Axes passed as null are skipped.
+	 */
+	void FillOccupancy(const std::vector<BlockID>& paddedData, int chunkSize, std::vector<uint64_t>* alongX, std::vector<uint64_t>* alongY, std::vector<uint64_t>* alongZ)
+	{
+		const int size = PaddedChunkVolume::Size(chunkSize);
+		for (std::vector<uint64_t>* rows : { alongX, alongY, alongZ })
+		{
+			if (rows)
+			{
+				rows->assign(static_cast<size_t>(size) * size, 0);
+			}
+		}
+
+		for (int px = 0; px < size; px++)
+		{
+			for (int pz = 0; pz < size; pz++)
+			{
+				const BlockID* const voxels = &paddedData[PaddedChunkVolume::Index(px - 1, -1, pz - 1, chunkSize)];
+				uint64_t column = 0;
+				for (int py = 0; py < size; py++)
+				{
+					column |= static_cast<uint64_t>(voxels[py] != 0) << py;
+				}
+
+				if (alongY)
+				{
+					(*alongY)[px * size + pz] = column;
+				}
+
+				for (uint64_t bits = (alongX || alongZ) ? column : 0; bits != 0; bits &= bits - 1)
+				{
+					const int py = std::countr_zero(bits);
+					if (alongX)
+					{
+						(*alongX)[py * size + pz] |= uint64_t(1) << px;
+					}
+					if (alongZ)
+					{
+						(*alongZ)[px * size + py] |= uint64_t(1) << pz;
+					}
+				}
+			}
+		}
+	}
+
+	/** Padded volumes ChunkBuildJob::VerifyMeshers meshes */
+	enum class EMesherTestVolume { Random, Uniform, Checkerboard, ApronEdges, Count };
+
+	/**
+	 * Fills a padded volume the way FillPaddedVolume would, leaving the apron's edges and corners air.
+	 * Returns whether the chunk itself is one solid block, which the meshers are told as bUniform.
+	 */
+	bool FillMesherTestVolume(EMesherTestVolume testVolume, int chunkSize, std::vector<BlockID>* paddedData)
+	{
+		// Fixed seed so a failure reproduces; the raw engine output is the same on every standard library
+		std::mt19937 random(static_cast<uint32_t>(chunkSize) * 31 + static_cast<uint32_t>(testVolume));
+		const auto randomBlock = [&random]() { return static_cast<BlockID>(random() % 4); };
+
+		paddedData->assign(PaddedChunkVolume::NumVoxels(chunkSize), 0);
+		for (int x = -1; x <= chunkSize; x++)
+		{
+			for (int y = -1; y <= chunkSize; y++)
+			{
+				for (int z = -1; z <= chunkSize; z++)
+				{
+					const int numOutside = (x < 0 || x == chunkSize) + (y < 0 || y == chunkSize) + (z < 0 || z == chunkSize);
+					if (numOutside > 1)
+					{
+						continue;
+					}
+
+					const bool bOnShell = x == 0 || y == 0 || z == 0 || x == chunkSize - 1 || y == chunkSize - 1 || z == chunkSize - 1;
+
+					BlockID block = 0;
+					switch (testVolume)
+					{
+					case EMesherTestVolume::Random:			block = randomBlock(); break;
+					case EMesherTestVolume::Uniform:		block = numOutside == 0 ? (BlockID)Block::EBlockType::STONE : randomBlock(); break;
+					case EMesherTestVolume::Checkerboard:	block = ((x + y + z) & 1) ? 0 : static_cast<BlockID>(1 + ((x ^ z) & 1)); break;
+
+					// Solid neighbour layers against a hollow chunk whose outer shell is random, so every face lands on a chunk edge
+					case EMesherTestVolume::ApronEdges:		block = numOutside == 1 ? (BlockID)Block::EBlockType::DIRT : (bOnShell ? randomBlock() : 0); break;
+					default: break;
+					}
+					(*paddedData)[PaddedChunkVolume::Index(x, y, z, chunkSize)] = block;
+				}
+			}
+		}
+
+		return testVolume == EMesherTestVolume::Uniform;
+	}
+}
+
+ChunkBuildJob::ChunkBuildJob(glm::ivec3 InChunkPos, int InChunkSize, std::shared_ptr<VoxelCache> InVoxelCache, std::shared_ptr<ColumnCache> InColumnCache,
+							 std::shared_ptr<const WorldGenerator> InGenerator, std::shared_ptr<FChunkJobStats> InStats, EMeshingMode InMeshingMode)
+	: chunkPos(InChunkPos), chunkSize(InChunkSize), voxelCache(std::move(InVoxelCache)), columnCache(std::move(InColumnCache)),
+	  worldGenerator(std::move(InGenerator)), stats(std::move(InStats)), meshingMode(InMeshingMode)
+{
+}
+
+bool ChunkBuildJob::VerifyMeshers()
+{
+	// An odd size that splits no words evenly, and the widest chunk the bitmask meshers handle
+	for (const int testChunkSize : { 13, MaxBinaryChunkSize })
+	{
+		// The meshers only read the padded volume and append to the scratch faces, so the job needs no caches
+		ChunkBuildJob job(glm::ivec3(0), testChunkSize, nullptr, nullptr, nullptr, nullptr, EMeshingMode::Naive);
+		FMeshScratch meshScratch;
+		job.scratch = &meshScratch;
+
+		std::vector<BlockID> paddedData;
+		bool bUniform = false;
+
+		// Face sets rather than counts, sorted since the meshers add faces in different orders
+		const auto meshFaces = [&](void (ChunkBuildJob::*mesher)(const std::vector<BlockID>&, bool))
+		{
+			meshScratch.Faces.clear();
+			(job.*mesher)(paddedData, bUniform);
+
+			std::vector<uint64_t> faces;
+			faces.reserve(meshScratch.Faces.size());
+			for (const FFaceInstance& face : meshScratch.Faces)
+			{
+				faces.push_back(static_cast<uint64_t>(face.BlockAndSize) << 32 | face.Position);
+			}
+			std::sort(faces.begin(), faces.end());
+			return faces;
+		};
+
+		for (int testVolume = 0; testVolume < static_cast<int>(EMesherTestVolume::Count); testVolume++)
+		{
+			bUniform = FillMesherTestVolume(static_cast<EMesherTestVolume>(testVolume), testChunkSize, &paddedData);
+
+			if (meshFaces(&ChunkBuildJob::MeshBinary) != meshFaces(&ChunkBuildJob::MeshNaive) ||
+				meshFaces(&ChunkBuildJob::MeshBinaryGreedy) != meshFaces(&ChunkBuildJob::MeshGreedy))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool ChunkBuildJob::Run()
+{
+	EState expected = EState::Queued;
+	if (!State.compare_exchange_strong(expected, EState::Running, std::memory_order_acq_rel))
+	{
+		stats->Skipped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Fetch the chunk's block data, generated at most once across all jobs
+	BlockData = voxelCache->GetOrGenerate(chunkPos);
+	if (ShouldAbandon())
+	{
+		return false;
+	}
+
+	if (!BuildMesh())
+	{
+		return false;
+	}
+
+	// A cancel that lands after this point finds the job finished and counts it as discarded instead
+	expected = EState::Running;
+	if (!State.compare_exchange_strong(expected, EState::Finished, std::memory_order_acq_rel))
+	{
+		stats->Abandoned.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	return true;
+}
+
+void ChunkBuildJob::Cancel()
+{
+	if (State.exchange(EState::Cancelled, std::memory_order_acq_rel) == EState::Finished)
+	{
+		stats->Discarded.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+bool ChunkBuildJob::ShouldAbandon()
+{
+	if (!IsCancelled())
+	{
+		return false;
+	}
+
+	stats->Abandoned.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool ChunkBuildJob::BuildMesh()
+{
+	// Uniform chunks share one volume; air has nothing to mesh
+	BlockID uniformBlock;
+	const bool bUniform = voxelCache->GetUniformBlock(BlockData, &uniformBlock);
+	if (bUniform && uniformBlock == (BlockID)Block::EBlockType::AIR)
+	{
+		Connectivity = FChunkConnectivity::All();
+		return true;
+	}
+
+	// Mesh from a decoded copy so neighbour lookups are plain array reads
+	thread_local std::vector<BlockID> blockData;
+	blockData.resize(BlockData->GetNumVoxels());
+	BlockData->Decode(blockData);
+
+	// A uniform solid chunk has no air, so it keeps the default of no connected faces
+	if (bUniform)
+	{
+		Occluders = FChunkOccluders::Solid();
+	}
+	else
+	{
+		Connectivity = FChunkConnectivity::Compute(blockData, chunkSize);
+		Occluders = FChunkOccluders::Compute(blockData, chunkSize);
+	}
+
+	const auto gatherStart = std::chrono::steady_clock::now();
+	thread_local std::vector<BlockID> paddedData;
+	FillPaddedVolume(blockData, &paddedData);
+
+	if (ShouldAbandon())
+	{
+		return false;
+	}
+
+	// Meshers append to this worker's scratch buffers, which keep their capacity from job to job
+	thread_local FMeshScratch meshScratch;
+	meshScratch.Faces.clear();
+	scratch = &meshScratch;
+
+	const auto meshingStart = std::chrono::steady_clock::now();
+	switch (meshingMode)
+	{
+	case EMeshingMode::Greedy:			MeshGreedy(paddedData, bUniform); break;
+	case EMeshingMode::Binary:			MeshBinary(paddedData, bUniform); break;
+	case EMeshingMode::BinaryGreedy:	MeshBinaryGreedy(paddedData, bUniform); break;
+	default:							MeshNaive(paddedData, bUniform); break;
+	}
+	const auto meshingEnd = std::chrono::steady_clock::now();
+
+	Mesh = MeshData(meshScratch.Faces);
+	scratch = nullptr;
+
+	FChunkJobStats::FMeshingStats& meshingStats = stats->Meshing[static_cast<int>(meshingMode)];
+	meshingStats.Chunks.fetch_add(1, std::memory_order_relaxed);
+	meshingStats.Faces.fetch_add(Mesh.GetNumFaces(), std::memory_order_relaxed);
+	meshingStats.Microseconds.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(meshingEnd - meshingStart).count(), std::memory_order_relaxed);
+	meshingStats.GatherMicroseconds.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(meshingStart - gatherStart).count(), std::memory_order_relaxed);
+
+	return true;
+}
+
+void ChunkBuildJob::FillPaddedVolume(const std::vector<BlockID>& blockData, std::vector<BlockID>* paddedData) const
+{
+	// The apron's edges and corners touch no face of the chunk, so they stay air
+	paddedData->assign(PaddedChunkVolume::NumVoxels(chunkSize), 0);
+
+	for (int x = 0; x < chunkSize; x++)
+	{
+		for (int z = 0; z < chunkSize; z++)
+		{
+			BlockID* const column = &(*paddedData)[PaddedChunkVolume::Index(x, 0, z, chunkSize)];
+			if constexpr (ChunkVolume::Layout == EVoxelLayout::YColumn)
+			{
+				std::copy_n(&blockData[ChunkVolume::Index(x, 0, z, chunkSize)], chunkSize, column);
+			}
+			else
+			{
+				for (int y = 0; y < chunkSize; y++)
+				{
+					column[y] = blockData[ChunkVolume::Index(x, y, z, chunkSize)];
+				}
+			}
+		}
+	}
+
+	// Meshing only needs the single layer of each neighbour that touches this chunk
+	thread_local std::vector<BlockID> slab;
+	for (int directionIndex = 0; directionIndex < 6; directionIndex++)
+	{
+		const EDirection direction = static_cast<EDirection>(directionIndex);
+		GetNeighbourSlab(direction, slab);
+
+		// Slabs are indexed by the two axes parallel to the face, in (x, z, y) priority order
+		for (int a = 0; a < chunkSize; a++)
+		{
+			for (int b = 0; b < chunkSize; b++)
+			{
+				glm::ivec3 apronPos;
+				switch (direction)
+				{
+				case EDirection::North:		apronPos = glm::ivec3(a, b, -1); break;
+				case EDirection::South:		apronPos = glm::ivec3(a, b, chunkSize); break;
+				case EDirection::East:		apronPos = glm::ivec3(chunkSize, b, a); break;
+				case EDirection::West:		apronPos = glm::ivec3(-1, b, a); break;
+				case EDirection::Top:		apronPos = glm::ivec3(a, chunkSize, b); break;
+				case EDirection::Bottom:	apronPos = glm::ivec3(a, -1, b); break;
+				}
+				(*paddedData)[PaddedChunkVolume::Index(apronPos, chunkSize)] = slab[a * chunkSize + b];
+			}
+		}
+	}
+}
+
+void ChunkBuildJob::MeshNaive(const std::vector<BlockID>& paddedData, bool bUniform)
+{
+	ptrdiff_t neighbourOffsets[6];
+	for (int direction = 0; direction < 6; direction++)
+	{
+		neighbourOffsets[direction] = PaddedChunkVolume::Offset(FaceQuads[direction].Normal, chunkSize);
+	}
+
+	for (int x = 0; x < chunkSize; x++)
+	{
+		for (int z = 0; z < chunkSize; z++)
+		{
+			// In a uniform solid chunk only faces on the outer shell can touch air, so interior columns skip to the top voxel
+			const bool bInteriorColumn = bUniform && x > 0 && x < chunkSize - 1 && z > 0 && z < chunkSize - 1;
+
+			for (int y = 0; y < chunkSize; y += (bInteriorColumn && y == 0) ? chunkSize - 1 : 1)
+			{
+				const size_t index = PaddedChunkVolume::Index(x, y, z, chunkSize);
+				if (paddedData[index] == 0)
+				{
+					continue;
+				}
+
+				const BlockID block = paddedData[index];
+
+				// Generate faces
+				for (int direction = 0; direction < 6; direction++)
+				{
+					if (paddedData[index + neighbourOffsets[direction]] == 0)
+					{
+						AddFace(static_cast<EDirection>(direction), glm::ivec3(x, y, z), glm::ivec3(1), block);
+					}
+				}
+			}
+		}
+	}
+}
+
+void ChunkBuildJob::MeshGreedy(const std::vector<BlockID>& paddedData, bool bUniform)
+{
+	// Block of each visible face, 0 where there is none, per direction indexed by (slice * chunkSize + v) * chunkSize + u
+	thread_local std::vector<BlockID> masks[6];
+	const size_t sliceArea = static_cast<size_t>(chunkSize) * chunkSize;
+	for (std::vector<BlockID>& mask : masks)
+	{
+		mask.assign(sliceArea * chunkSize, 0);
+	}
+
+	ptrdiff_t neighbourOffsets[6];
+	for (int direction = 0; direction < 6; direction++)
+	{
+		neighbourOffsets[direction] = PaddedChunkVolume::Offset(FaceQuads[direction].Normal, chunkSize);
+	}
+
+	// Faces are found in one pass in storage order; walking each direction's slices directly strides across the volume
+	for (int x = 0; x < chunkSize; x++)
+	{
+		for (int z = 0; z < chunkSize; z++)
+		{
+			const bool bInteriorColumn = bUniform && x > 0 && x < chunkSize - 1 && z > 0 && z < chunkSize - 1;
+
+			for (int y = 0; y < chunkSize; y += (bInteriorColumn && y == 0) ? chunkSize - 1 : 1)
+			{
+				const size_t index = PaddedChunkVolume::Index(x, y, z, chunkSize);
+				const BlockID block = paddedData[index];
+				if (block == 0)
+				{
+					continue;
+				}
+
+				const glm::ivec3 cell(x, y, z);
+				for (int direction = 0; direction < 6; direction++)
+				{
+					if (paddedData[index + neighbourOffsets[direction]] == 0)
+					{
+						const FFaceQuad& face = FaceQuads[direction];
+						const int normalAxis = 3 - face.UAxis - face.VAxis;
+						masks[direction][(cell[normalAxis] * chunkSize + cell[face.VAxis]) * chunkSize + cell[face.UAxis]] = block;
+					}
+				}
+			}
+		}
+	}
+
+	for (int directionIndex = 0; directionIndex < 6; directionIndex++)
+	{
+		const EDirection direction = static_cast<EDirection>(directionIndex);
+		const FFaceQuad& face = FaceQuads[directionIndex];
+		const int normalAxis = 3 - face.UAxis - face.VAxis;
+
+		for (int slice = 0; slice < chunkSize; slice++)
+		{
+			BlockID* const mask = masks[directionIndex].data() + slice * sliceArea;
+
+			for (int v = 0; v < chunkSize; v++)
+			{
+				for (int u = 0; u < chunkSize;)
+				{
+					const BlockID block = mask[v * chunkSize + u];
+					if (block == 0)
+					{
+						u++;
+						continue;
+					}
+
+					int width = 1;
+					while (u + width < chunkSize && mask[v * chunkSize + u + width] == block)
+					{
+						width++;
+					}
+
+					// Grow down the slice while the whole next row of the rectangle is the same block
+					int height = 1;
+					while (v + height < chunkSize && std::all_of(mask + (v + height) * chunkSize + u, mask + (v + height) * chunkSize + u + width,
+																 [block](BlockID other) { return other == block; }))
+					{
+						height++;
+					}
+
+					for (int row = v; row < v + height; row++)
+					{
+						std::fill_n(mask + row * chunkSize + u, width, BlockID(0));
+					}
+
+					glm::ivec3 quadCell;
+					glm::ivec3 quadSize;
+					quadCell[normalAxis] = slice;
+					quadCell[face.UAxis] = u;
+					quadCell[face.VAxis] = v;
+					quadSize[normalAxis] = 1;
+					quadSize[face.UAxis] = width;
+					quadSize[face.VAxis] = height;
+					AddFace(direction, quadCell, quadSize, block);
+
+					u += width;
+				}
+			}
+		}
+	}
+}
+
+void ChunkBuildJob::MeshBinary(const std::vector<BlockID>& paddedData, bool bUniform)
+{
+	if (chunkSize > MaxBinaryChunkSize)
+	{
+		MeshNaive(paddedData, bUniform);
+		return;
+	}
+
+	thread_local std::vector<uint64_t> alongY;
+	FillOccupancy(paddedData, chunkSize, nullptr, &alongY, nullptr);
+
+	const int size = PaddedChunkVolume::Size(chunkSize);
+	const uint64_t inside = LowBits(chunkSize) << 1;
+
+	for (int x = 0; x < chunkSize; x++)
+	{
+		for (int z = 0; z < chunkSize; z++)
+		{
+			// Columns are in padded coordinates, so the neighbouring chunks' layers are just more bits and columns
+			const size_t columnIndex = (x + 1) * size + (z + 1);
+			const uint64_t column = alongY[columnIndex];
+			const uint64_t solid = column & inside;
+			if (solid == 0)
+			{
+				continue;
+			}
+
+			// A face is visible where this column is solid and the neighbouring column, or the next voxel up or down, is not
+			uint64_t faces[6];
+			faces[static_cast<int>(EDirection::North)] = solid & ~alongY[columnIndex - 1];
+			faces[static_cast<int>(EDirection::South)] = solid & ~alongY[columnIndex + 1];
+			faces[static_cast<int>(EDirection::East)] = solid & ~alongY[columnIndex + size];
+			faces[static_cast<int>(EDirection::West)] = solid & ~alongY[columnIndex - size];
+			faces[static_cast<int>(EDirection::Top)] = solid & ~(column >> 1);
+			faces[static_cast<int>(EDirection::Bottom)] = solid & ~(column << 1);
+
+			uint64_t anyFace = 0;
+			for (const uint64_t directionFaces : faces)
+			{
+				anyFace |= directionFaces;
+			}
+
+			// Voxels bottom to top and directions in EDirection order, the order MeshNaive adds them in
+			for (; anyFace != 0; anyFace &= anyFace - 1)
+			{
+				const int py = std::countr_zero(anyFace);
+				const glm::ivec3 cell(x, py - 1, z);
+				const BlockID block = paddedData[PaddedChunkVolume::Index(cell, chunkSize)];
+				for (int direction = 0; direction < 6; direction++)
+				{
+					if ((faces[direction] >> py) & 1)
+					{
+						AddFace(static_cast<EDirection>(direction), cell, glm::ivec3(1), block);
+					}
+				}
+			}
+		}
+	}
+}
+
+void ChunkBuildJob::MeshBinaryGreedy(const std::vector<BlockID>& paddedData, bool bUniform)
+{
+	if (chunkSize > MaxBinaryChunkSize)
+	{
+		MeshGreedy(paddedData, bUniform);
+		return;
+	}
+
+	// Every face's u axis is x or z, so slices are built from rows along those
+	thread_local std::vector<uint64_t> alongX;
+	thread_local std::vector<uint64_t> alongZ;
+	FillOccupancy(paddedData, chunkSize, &alongX, nullptr, &alongZ);
+
+	const int size = PaddedChunkVolume::Size(chunkSize);
+	const uint64_t inside = LowBits(chunkSize);
+	uint64_t rows[MaxBinaryChunkSize];
+
+	for (int directionIndex = 0; directionIndex < 6; directionIndex++)
+	{
+		const EDirection direction = static_cast<EDirection>(directionIndex);
+		const FFaceQuad& face = FaceQuads[directionIndex];
+		const int normalAxis = 3 - face.UAxis - face.VAxis;
+
+		// Index of the row through a cell, ignoring its u coordinate
+		const std::vector<uint64_t>& occupancy = face.UAxis == 0 ? alongX : alongZ;
+		auto rowIndex = [&](const glm::ivec3& cell)
+		{
+			return face.UAxis == 0 ? (cell.y + 1) * size + (cell.z + 1) : (cell.x + 1) * size + (cell.y + 1);
+		};
+
+		for (int slice = 0; slice < chunkSize; slice++)
+		{
+			glm::ivec3 cell(0);
+			cell[normalAxis] = slice;
+
+			// Visible faces of the slice as one word per v, masking each row of voxels with the row in front of it
+			for (int v = 0; v < chunkSize; v++)
+			{
+				cell[face.VAxis] = v;
+				rows[v] = ((occupancy[rowIndex(cell)] & ~occupancy[rowIndex(cell + face.Normal)]) >> 1) & inside;
+			}
+
+			auto blockAt = [&](int u, int v)
+			{
+				cell[face.UAxis] = u;
+				cell[face.VAxis] = v;
+				return paddedData[PaddedChunkVolume::Index(cell, chunkSize)];
+			};
+
+			// Same scan order and merge rules as MeshGreedy, with runs of faces found by bit scans
+			for (int v = 0; v < chunkSize; v++)
+			{
+				while (rows[v] != 0)
+				{
+					const int u = std::countr_zero(rows[v]);
+					const BlockID block = blockAt(u, v);
+
+					int width = 1;
+					while (u + width < chunkSize && ((rows[v] >> (u + width)) & 1) && blockAt(u + width, v) == block)
+					{
+						width++;
+					}
+
+					const uint64_t span = LowBits(width) << u;
+					int height = 1;
+					while (v + height < chunkSize && (rows[v + height] & span) == span)
+					{
+						bool bSameBlock = true;
+						for (int spanU = u; spanU < u + width && bSameBlock; spanU++)
+						{
+							bSameBlock = blockAt(spanU, v + height) == block;
+						}
+						if (!bSameBlock)
+						{
+							break;
+						}
+						height++;
+					}
+
+					for (int row = v; row < v + height; row++)
+					{
+						rows[row] &= ~span;
+					}
+
+					glm::ivec3 quadCell;
+					glm::ivec3 quadSize;
+					quadCell[normalAxis] = slice;
+					quadCell[face.UAxis] = u;
+					quadCell[face.VAxis] = v;
+					quadSize[normalAxis] = 1;
+					quadSize[face.UAxis] = width;
+					quadSize[face.VAxis] = height;
+					AddFace(direction, quadCell, quadSize, block);
+				}
+			}
+		}
+	}
+}
+
+void ChunkBuildJob::GetNeighbourSlab(EDirection direction, std::vector<BlockID>& slabData) const
+{
+	glm::ivec3 neighbourPos = chunkPos;
+	int axis = 0;
+	int layer = 0;
+
+	switch (direction)
+	{
+	case EDirection::North:		neighbourPos.z -= 1; axis = 2; layer = chunkSize - 1; break;
+	case EDirection::South:		neighbourPos.z += 1; axis = 2; layer = 0; break;
+	case EDirection::West:		neighbourPos.x -= 1; axis = 0; layer = chunkSize - 1; break;
+	case EDirection::East:		neighbourPos.x += 1; axis = 0; layer = 0; break;
+	case EDirection::Bottom:	neighbourPos.y -= 1; axis = 1; layer = chunkSize - 1; break;
+	case EDirection::Top:		neighbourPos.y += 1; axis = 1; layer = 0; break;
+	}
+
+	// Generating a single layer is ~chunkSize times cheaper than a full volume, so only reuse one that already exists
+	const VoxelData neighbourData = voxelCache->Find(neighbourPos);
+	if (!neighbourData)
+	{
+		const std::shared_ptr<const FColumnData> columnData = columnCache->GetOrGenerate(neighbourPos.x, neighbourPos.z);
+		worldGenerator->GenerateChunkSlab(neighbourPos.x, neighbourPos.y, neighbourPos.z, chunkSize, *columnData, axis, layer, &slabData);
+		return;
+	}
+
+	const BlockStorage& volume = *neighbourData;
+	slabData.resize(chunkSize * chunkSize);
+
+	BlockID uniformBlock;
+	if (voxelCache->GetUniformBlock(neighbourData, &uniformBlock))
+	{
+		std::fill(slabData.begin(), slabData.end(), uniformBlock);
+		return;
+	}
+
+	for (int a = 0; a < chunkSize; a++)
+	{
+		for (int b = 0; b < chunkSize; b++)
+		{
+			switch (axis)
+			{
+			case 0: slabData[a * chunkSize + b] = volume.Get(ChunkVolume::Index(layer, b, a, chunkSize)); break;
+			case 1: slabData[a * chunkSize + b] = volume.Get(ChunkVolume::Index(a, layer, b, chunkSize)); break;
+			case 2: slabData[a * chunkSize + b] = volume.Get(ChunkVolume::Index(a, b, layer, chunkSize)); break;
+			}
+		}
+	}
+}
+
+void ChunkBuildJob::AddFace(EDirection direction, const glm::ivec3& cell, const glm::ivec3& size, BlockID block)
+{
+	const FFaceQuad& face = FaceQuads[static_cast<int>(direction)];
+	scratch->Faces.emplace_back(cell.x, cell.y, cell.z, static_cast<uint8_t>(direction), size[face.UAxis], size[face.VAxis], block);
+}
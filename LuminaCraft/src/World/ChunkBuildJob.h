@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../MPSCQueue.h"
+#include "../Renderer/MeshData.h"
+#include "ChunkVisibility.h"
+#include "VoxelCache.h"
+
+class ColumnCache;
+class WorldGenerator;
+
+class ChunkBuildJob;
+
+/** Finished build jobs, pushed by pool threads and drained by the main thread once per frame */
+using ChunkJobQueue = TMPSCQueue<std::shared_ptr<ChunkBuildJob>>;
+
+/** How a chunk's visible block faces are turned into quads */
+enum class EMeshingMode : uint8_t
+{
+	/** One quad per visible block face */
+	Naive,
+
+	/** Coplanar faces of the same block merged into maximal rectangles, slice by slice */
+	Greedy,
+
+	/** Visible faces found 32 voxels at a time from occupancy bitmasks, one quad each. Builds the same mesh as Naive. */
+	Binary,
+
+	/** Bitmask face finding with the greedy merge on top. Builds the same mesh as Greedy. */
+	BinaryGreedy,
+
+	Count
+};
+
+/** Counters shared by every chunk job of a world */
+struct FChunkJobStats
+{
+	/** Size and cost of the meshes built in one meshing mode */
+	struct FMeshingStats
+	{
+		std::atomic<uint64_t> Chunks = 0;
+		std::atomic<uint64_t> Faces = 0;
+		std::atomic<uint64_t> Microseconds = 0;
+
+		/** Spent filling the padded meshing input, neighbour slabs included */
+		std::atomic<uint64_t> GatherMicroseconds = 0;
+	};
+
+	/** Indexed by EMeshingMode. Chunks of air are not meshed and not counted. */
+	FMeshingStats Meshing[static_cast<int>(EMeshingMode::Count)];
+
+	/** Jobs submitted to the pool whose task has not returned yet, however it ends */
+	std::atomic<uint32_t> InFlight = 0;
+
+	// Jobs whose work was thrown away because their chunk was dropped
+
+	/** Cancelled before a worker picked them up */
+	std::atomic<uint64_t> Skipped = 0;
+
+	/** Cancelled while running, stopped at the next stage boundary */
+	std::atomic<uint64_t> Abandoned = 0;
+
+	/** Finished, but the chunk was dropped before it uploaded the mesh */
+	std::atomic<uint64_t> Discarded = 0;
+};
+
+/**
+ * Generates and meshes one chunk on a pool thread.
+ * The job owns its inputs and outputs and the pool task holds a reference to it, so the chunk that submitted it can be
+ * destroyed at any time: it cancels the job, which is skipped if it hasn't started and abandoned at the next stage
+ * boundary otherwise.
+ */
+class ChunkBuildJob
+{
+public:
+
+	enum class EDirection { North, South, East, West, Top, Bottom };
+
+	ChunkBuildJob(glm::ivec3 InChunkPos, int InChunkSize, std::shared_ptr<VoxelCache> InVoxelCache, std::shared_ptr<ColumnCache> InColumnCache,
+				  std::shared_ptr<const WorldGenerator> InGenerator, std::shared_ptr<FChunkJobStats> InStats, EMeshingMode InMeshingMode);
+
+	/** Runs on a pool thread. Returns true if the job finished without being cancelled, making its outputs valid. */
+	bool Run();
+
+	/** Safe to call from any thread, any number of times */
+	void Cancel();
+
+	bool IsCancelled() const { return State.load(std::memory_order_acquire) == EState::Cancelled; }
+
+	const glm::ivec3& GetChunkPos() const { return chunkPos; }
+
+	/**
+	 * Meshes fixed random, uniform, checkerboard and apron-edge volumes in every mode and checks that Binary builds
+	 * exactly Naive's faces and BinaryGreedy exactly Greedy's
+	 */
+	static bool VerifyMeshers();
+
+public:
+
+	/** Generated volume, shared with the voxel cache */
+	VoxelData BlockData;
+
+	/** The finished mesh, sized exactly; empty for chunks with no visible faces */
+	MeshData Mesh;
+
+	/** Which faces of the chunk its air joins, computed alongside the mesh */
+	FChunkConnectivity Connectivity;
+
+	/** Solid boxes of the chunk for the occlusion buffer */
+	FChunkOccluders Occluders;
+
+private:
+
+	enum class EState : uint8_t { Queued, Running, Finished, Cancelled };
+
+	/** Growable buffers the meshers append to, one set per worker thread */
+	struct FMeshScratch
+	{
+		std::vector<FFaceInstance> Faces;
+	};
+
+	/** Checked between stages. Counts the job as abandoned and returns true if it was cancelled. */
+	bool ShouldAbandon();
+
+	/** Returns false if the job was cancelled part way through */
+	bool BuildMesh();
+
+	/** Fills the chunkSize x chunkSize layer of the neighbour that touches this chunk in the given direction */
+	void GetNeighbourSlab(EDirection direction, std::vector<BlockID>& slabData) const;
+
+	/** Copies the decoded chunk into a PaddedChunkVolume and fills its apron from the neighbours' touching layers */
+	void FillPaddedVolume(const std::vector<BlockID>& blockData, std::vector<BlockID>* paddedData) const;
+
+	/** One quad per visible face. The meshers all read a volume filled by FillPaddedVolume. */
+	void MeshNaive(const std::vector<BlockID>& paddedData, bool bUniform);
+
+	/** Per direction and slice, masks the visible faces by block and covers each block's faces with as few rectangles as it greedily can */
+	void MeshGreedy(const std::vector<BlockID>& paddedData, bool bUniform);
+
+	/** Naive's mesh from occupancy bitmasks of the columns along y. Falls back to MeshNaive for chunks wider than 62. */
+	void MeshBinary(const std::vector<BlockID>& paddedData, bool bUniform);
+
+	/** Greedy's mesh from occupancy bitmasks of the rows along x and z. Falls back to MeshGreedy for chunks wider than 62. */
+	void MeshBinaryGreedy(const std::vector<BlockID>& paddedData, bool bUniform);
+
+	/** Adds the face of the cells in [cell, cell + size) that points in direction, as one instance with the block's texture repeated per block */
+	void AddFace(EDirection direction, const glm::ivec3& cell, const glm::ivec3& size, BlockID block);
+
+private:
+
+	glm::ivec3 chunkPos;
+	int32_t chunkSize;
+
+	std::shared_ptr<VoxelCache> voxelCache;
+	std::shared_ptr<ColumnCache> columnCache;
+	std::shared_ptr<const WorldGenerator> worldGenerator;
+	std::shared_ptr<FChunkJobStats> stats;
+	EMeshingMode meshingMode;
+
+	/** The running thread's scratch buffers while the job is meshing */
+	FMeshScratch* scratch = nullptr;
+
+	std::atomic<EState> State = EState::Queued;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+
+/**
+ * Chunk coordinate packed into one 64-bit integer, 21 signed bits per axis (+-1M chunks, +-33M blocks at 32 per chunk).
+ * Used as the key wherever chunks are looked up, queued or cached.
+ */
+struct ChunkCoord
+{
+	static constexpr int BitsPerAxis = 21;
+
+	ChunkCoord() = default;
+
+	ChunkCoord(int x, int y, int z)
+		: Packed((PackAxis(x) << (2 * BitsPerAxis)) | (PackAxis(y) << BitsPerAxis) | PackAxis(z))
+	{
+	}
+
+	explicit ChunkCoord(const glm::ivec3& chunkPos)
+		: ChunkCoord(chunkPos.x, chunkPos.y, chunkPos.z)
+	{
+	}
+
+	int GetX() const { return UnpackAxis(Packed >> (2 * BitsPerAxis)); }
+	int GetY() const { return UnpackAxis(Packed >> BitsPerAxis); }
+	int GetZ() const { return UnpackAxis(Packed); }
+
+	glm::ivec3 ToIVec3() const { return { GetX(), GetY(), GetZ() }; }
+
+	bool operator==(const ChunkCoord& other) const = default;
+
+	uint64_t Packed = 0;
+
+private:
+
+	static constexpr uint64_t AxisMask = (uint64_t(1) << BitsPerAxis) - 1;
+
+	static uint64_t PackAxis(int value)
+	{
+		return static_cast<uint64_t>(static_cast<int64_t>(value)) & AxisMask;
+	}
+
+	static int UnpackAxis(uint64_t bits)
+	{
+		// Shift the axis to the top of the word and arithmetic-shift back down to sign extend it
+		return static_cast<int>(static_cast<int64_t>((bits & AxisMask) << (64 - BitsPerAxis)) >> (64 - BitsPerAxis));
+	}
+};
+
+namespace std
+{
+	/** Murmur3 fmix64 finaliser. Neighbouring coordinates differ in only a few low bits of each axis, so they need full avalanche. */
+	template <>
+	struct hash<ChunkCoord>
+	{
+		size_t operator()(const ChunkCoord& coord) const
+		{
+			uint64_t h = coord.Packed;
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+			return static_cast<size_t>(h);
+		}
+	};
+}
@@ -0,0 +1,135 @@
+#include "ChunkCuller.h"
+
+void ChunkCuller::FBoxList::Clear()
+{
+	MinX.clear();
+	MinY.clear();
+	MinZ.clear();
+	MaxX.clear();
+	MaxY.clear();
+	MaxZ.clear();
+}
+
+void ChunkCuller::FBoxList::Add(const glm::vec3& min, const glm::vec3& max)
+{
+	MinX.push_back(min.x);
+	MinY.push_back(min.y);
+	MinZ.push_back(min.z);
+	MaxX.push_back(max.x);
+	MaxY.push_back(max.y);
+	MaxZ.push_back(max.z);
+}
+
+void ChunkCuller::Cull(const Frustum& frustum, const std::vector<glm::ivec3>& chunkPositions, int chunkSize, std::vector<uint32_t>* visible)
+{
+	NumRegions = NumRegionsCulled = NumRegionsInside = NumChunksTested = NumChunksCulled = 0;
+	if (chunkPositions.empty())
+	{
+		return;
+	}
+
+	// Regions are indexed densely over the bounds of the input; arithmetic shifts floor negative coordinates
+	glm::ivec3 minRegion = chunkPositions[0] >> RegionShift;
+	glm::ivec3 maxRegion = minRegion;
+	for (const glm::ivec3& chunkPos : chunkPositions)
+	{
+		minRegion = glm::min(minRegion, chunkPos >> RegionShift);
+		maxRegion = glm::max(maxRegion, chunkPos >> RegionShift);
+	}
+
+	const glm::ivec3 regionDims = maxRegion - minRegion + 1;
+	const size_t numRegions = static_cast<size_t>(regionDims.x) * regionDims.y * regionDims.z;
+	const auto RegionIndex = [&](const glm::ivec3& chunkPos)
+	{
+		const glm::ivec3 region = (chunkPos >> RegionShift) - minRegion;
+		return static_cast<size_t>((region.x * regionDims.z + region.z) * regionDims.y + region.y);
+	};
+
+	// Counting sort of the chunks by region
+	RegionStart.assign(numRegions + 1, 0);
+	for (const glm::ivec3& chunkPos : chunkPositions)
+	{
+		RegionStart[RegionIndex(chunkPos) + 1]++;
+	}
+	for (size_t region = 0; region < numRegions; region++)
+	{
+		RegionStart[region + 1] += RegionStart[region];
+	}
+
+	RegionChunks.resize(chunkPositions.size());
+	RegionCursor.assign(RegionStart.begin(), RegionStart.end() - 1);
+	for (uint32_t chunk = 0; chunk < chunkPositions.size(); chunk++)
+	{
+		RegionChunks[RegionCursor[RegionIndex(chunkPositions[chunk])]++] = chunk;
+	}
+
+	// Coarse pass over the occupied regions
+	const float regionWorldSize = static_cast<float>(chunkSize << RegionShift);
+	OccupiedRegions.clear();
+	RegionBoxes.Clear();
+	for (uint32_t region = 0; region < numRegions; region++)
+	{
+		if (RegionStart[region + 1] == RegionStart[region])
+		{
+			continue;
+		}
+
+		const glm::ivec3 regionPos = glm::ivec3(region / (regionDims.z * regionDims.y), region % regionDims.y, (region / regionDims.y) % regionDims.z) + minRegion;
+		const glm::vec3 regionMin = glm::vec3(regionPos) * regionWorldSize;
+
+		OccupiedRegions.push_back(region);
+		RegionBoxes.Add(regionMin, regionMin + regionWorldSize);
+	}
+
+	NumRegions = OccupiedRegions.size();
+	Results.resize(NumRegions);
+	frustum.classifyBoxes(RegionBoxes.View(), static_cast<int>(NumRegions), Results.data());
+
+	TestedChunks.clear();
+	ChunkBoxes.Clear();
+	for (size_t i = 0; i < NumRegions; i++)
+	{
+		const uint32_t begin = RegionStart[OccupiedRegions[i]];
+		const uint32_t end = RegionStart[OccupiedRegions[i] + 1];
+
+		switch (Results[i])
+		{
+		case EFrustumTest::Outside:
+			NumRegionsCulled++;
+			NumChunksCulled += end - begin;
+			break;
+
+		case EFrustumTest::Inside:
+			NumRegionsInside++;
+			visible->insert(visible->end(), RegionChunks.begin() + begin, RegionChunks.begin() + end);
+			break;
+
+		case EFrustumTest::Intersecting:
+			for (uint32_t j = begin; j < end; j++)
+			{
+				const glm::vec3 chunkMin = glm::vec3(chunkPositions[RegionChunks[j]] * chunkSize);
+
+				TestedChunks.push_back(RegionChunks[j]);
+				ChunkBoxes.Add(chunkMin, chunkMin + static_cast<float>(chunkSize));
+			}
+			break;
+		}
+	}
+
+	// Fine pass over the chunks in regions that cross a plane
+	NumChunksTested = TestedChunks.size();
+	Results.resize(NumChunksTested);
+	frustum.classifyBoxes(ChunkBoxes.View(), static_cast<int>(NumChunksTested), Results.data());
+
+	for (size_t i = 0; i < NumChunksTested; i++)
+	{
+		if (Results[i] == EFrustumTest::Outside)
+		{
+			NumChunksCulled++;
+		}
+		else
+		{
+			visible->push_back(TestedChunks[i]);
+		}
+	}
+}
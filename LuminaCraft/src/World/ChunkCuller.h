@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../Renderer/Frustum.h"
+
+/**
+ * Frustum culls chunk draws in two passes. Chunks are bucketed into 4x4x4 chunk regions and the region boxes are
+ * tested first: chunks in regions fully outside are dropped and chunks in regions fully inside are kept without
+ * further tests. Only chunks in regions crossing a plane get their own box test. Both passes test boxes in SIMD batches.
+ *
+ * Scratch buffers are kept between frames so culling does not allocate once they have grown.
+ */
+class ChunkCuller
+{
+public:
+
+	/** log2 of the region size in chunks */
+	static constexpr int RegionShift = 2;
+
+	/** Appends the indices into chunkPositions of the chunks that may be visible */
+	void Cull(const Frustum& frustum, const std::vector<glm::ivec3>& chunkPositions, int chunkSize, std::vector<uint32_t>* visible);
+
+	/** Stats of the last Cull call */
+	size_t GetNumRegions() const { return NumRegions; }
+	size_t GetNumRegionsCulled() const { return NumRegionsCulled; }
+	size_t GetNumRegionsInside() const { return NumRegionsInside; }
+	size_t GetNumChunksTested() const { return NumChunksTested; }
+	size_t GetNumChunksCulled() const { return NumChunksCulled; }
+
+private:
+
+	/** Box bounds in SoA form, filled per pass */
+	struct FBoxList
+	{
+		std::vector<float> MinX, MinY, MinZ, MaxX, MaxY, MaxZ;
+
+		void Clear();
+		void Add(const glm::vec3& min, const glm::vec3& max);
+		size_t Size() const { return MinX.size(); }
+		FBoxesSoA View() const { return { MinX.data(), MinY.data(), MinZ.data(), MaxX.data(), MaxY.data(), MaxZ.data() }; }
+	};
+
+private:
+
+	/** Per region, the start of its chunks in RegionChunks; one extra entry marks the end */
+	std::vector<uint32_t> RegionStart;
+
+	/** Next free slot of each region in RegionChunks while bucketing */
+	std::vector<uint32_t> RegionCursor;
+
+	/** Chunk indices grouped by region */
+	std::vector<uint32_t> RegionChunks;
+
+	/** Dense indices of the regions that hold chunks */
+	std::vector<uint32_t> OccupiedRegions;
+
+	/** Chunk indices whose own box is tested */
+	std::vector<uint32_t> TestedChunks;
+
+	FBoxList RegionBoxes;
+	FBoxList ChunkBoxes;
+	std::vector<EFrustumTest> Results;
+
+	size_t NumRegions = 0;
+	size_t NumRegionsCulled = 0;
+	size_t NumRegionsInside = 0;
+	size_t NumChunksTested = 0;
+	size_t NumChunksCulled = 0;
+};
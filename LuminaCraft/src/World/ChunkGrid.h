@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ChunkCoord.h"
+
+/**
+ * Toroidal ring buffer of chunks covering a fixed box around a moving centre.
+ * A chunk's slot is its coordinate modulo the box size on each axis, so lookups are plain array indexing, and moving
+ * the centre by one chunk only evicts the one slab of slots that left the box.
+ */
+template <typename TValue>
+class TChunkGrid
+{
+public:
+
+	TChunkGrid() = default;
+
+	/** Drops every chunk and resizes the box to [center - radius, center + radius] on each axis */
+	void Reset(const glm::ivec3& InRadius, const glm::ivec3& InCenter = glm::ivec3(0))
+	{
+		Radius = InRadius;
+		Extent = 2 * InRadius + 1;
+		Center = InCenter;
+
+		Slots.clear();
+		Slots.resize(static_cast<size_t>(Extent.x) * Extent.y * Extent.z);
+		Count = 0;
+	}
+
+	/**
+	 * Moves the box and calls onEvict(coord, value) for every chunk that is no longer inside it, before removing it.
+	 * Only the slabs that left the box are visited unless the centre jumped further than the box is wide.
+	 */
+	template <typename TEvictFunction>
+	void Recenter(const glm::ivec3& newCenter, TEvictFunction&& onEvict)
+	{
+		const glm::ivec3 delta = newCenter - Center;
+		Center = newCenter;
+
+		if (delta == glm::ivec3(0) || Count == 0)
+		{
+			return;
+		}
+
+		if (glm::any(glm::greaterThanEqual(glm::abs(delta), Extent)))
+		{
+			for (FSlot& slot : Slots)
+			{
+				EvictIfOutside(slot, onEvict);
+			}
+			return;
+		}
+
+		// Coordinates that left the box on an axis all share the slab of slots at their residue on that axis
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const int oldMin = Center[axis] - delta[axis] - Radius[axis];
+			const int oldMax = Center[axis] - delta[axis] + Radius[axis];
+			const int leftMin = delta[axis] > 0 ? oldMin : oldMax + delta[axis] + 1;
+			const int leftMax = delta[axis] > 0 ? oldMin + delta[axis] - 1 : oldMax;
+
+			for (int coord = leftMin; coord <= leftMax; coord++)
+			{
+				const int layer = Wrap(coord, Extent[axis]);
+				const int axisU = (axis + 1) % 3;
+				const int axisV = (axis + 2) % 3;
+
+				glm::ivec3 slotPos;
+				slotPos[axis] = layer;
+
+				for (int u = 0; u < Extent[axisU]; u++)
+				{
+					slotPos[axisU] = u;
+					for (int v = 0; v < Extent[axisV]; v++)
+					{
+						slotPos[axisV] = v;
+						EvictIfOutside(Slots[SlotIndex(slotPos)], onEvict);
+					}
+				}
+			}
+		}
+	}
+
+	bool Contains(const glm::ivec3& chunkPos) const
+	{
+		return glm::all(glm::lessThanEqual(glm::abs(chunkPos - Center), Radius));
+	}
+
+	/** Returns the chunk at chunkPos, or nullptr if it is outside the box or not loaded */
+	TValue* Find(const glm::ivec3& chunkPos)
+	{
+		if (!Contains(chunkPos))
+		{
+			return nullptr;
+		}
+
+		FSlot& slot = Slots[SlotIndex(chunkPos)];
+		return slot.bOccupied ? &slot.Value : nullptr;
+	}
+
+	const TValue* Find(const glm::ivec3& chunkPos) const
+	{
+		return const_cast<TChunkGrid*>(this)->Find(chunkPos);
+	}
+
+	TValue* Find(const ChunkCoord& coord) { return Find(coord.ToIVec3()); }
+	const TValue* Find(const ChunkCoord& coord) const { return Find(coord.ToIVec3()); }
+
+	/** Stores value at chunkPos. Fails if chunkPos is outside the box or already loaded. */
+	bool Insert(const glm::ivec3& chunkPos, TValue value)
+	{
+		if (!Contains(chunkPos))
+		{
+			return false;
+		}
+
+		FSlot& slot = Slots[SlotIndex(chunkPos)];
+		if (slot.bOccupied)
+		{
+			return false;
+		}
+
+		slot.Coord = ChunkCoord(chunkPos);
+		slot.Value = std::move(value);
+		slot.bOccupied = true;
+		Count++;
+
+		return true;
+	}
+
+	bool Erase(const glm::ivec3& chunkPos)
+	{
+		if (!Contains(chunkPos))
+		{
+			return false;
+		}
+
+		FSlot& slot = Slots[SlotIndex(chunkPos)];
+		if (!slot.bOccupied)
+		{
+			return false;
+		}
+
+		Clear(slot);
+		return true;
+	}
+
+	/** Calls function(coord, value) for every loaded chunk */
+	template <typename TFunction>
+	void ForEach(TFunction&& function)
+	{
+		for (FSlot& slot : Slots)
+		{
+			if (slot.bOccupied)
+			{
+				function(slot.Coord, slot.Value);
+			}
+		}
+	}
+
+	size_t Size() const { return Count; }
+	const glm::ivec3& GetCenter() const { return Center; }
+	const glm::ivec3& GetRadius() const { return Radius; }
+
+private:
+
+	struct FSlot
+	{
+		ChunkCoord Coord;
+		TValue Value = TValue();
+		bool bOccupied = false;
+	};
+
+	static int Wrap(int value, int size)
+	{
+		const int wrapped = value % size;
+		return wrapped < 0 ? wrapped + size : wrapped;
+	}
+
+	size_t SlotIndex(const glm::ivec3& chunkPos) const
+	{
+		return (static_cast<size_t>(Wrap(chunkPos.x, Extent.x)) * Extent.z + Wrap(chunkPos.z, Extent.z)) * Extent.y + Wrap(chunkPos.y, Extent.y);
+	}
+
+	void Clear(FSlot& slot)
+	{
+		slot.Value = TValue();
+		slot.bOccupied = false;
+		Count--;
+	}
+
+	template <typename TEvictFunction>
+	void EvictIfOutside(FSlot& slot, TEvictFunction& onEvict)
+	{
+		if (slot.bOccupied && !Contains(slot.Coord.ToIVec3()))
+		{
+			onEvict(slot.Coord, slot.Value);
+			Clear(slot);
+		}
+	}
+
+private:
+
+	glm::ivec3 Radius = glm::ivec3(0);
+	glm::ivec3 Extent = glm::ivec3(0);
+	glm::ivec3 Center = glm::ivec3(0);
+
+	std::vector<FSlot> Slots;
+	size_t Count = 0;
+};
@@ -0,0 +1,124 @@
+#include "ChunkScheduler.h"
+
+#include <algorithm>
+
+namespace
+{
+	/** Turning further than this (about 15 degrees) re-sorts the pending heap */
+	constexpr float ReprioritiseDot = 0.966f;
+
+	/** Moving this many chunks from where the heap was sorted re-sorts it */
+	constexpr int ReprioritiseDrift = 2;
+}
+
+ChunkScheduler::ChunkScheduler(uint32_t InMaxInFlight)
+{
+	SetMaxInFlight(InMaxInFlight);
+}
+
+void ChunkScheduler::Add(const ChunkCoord& coord)
+{
+	if (!PendingSet.TryEmplace(coord, uint8_t(1)).second)
+	{
+		return;
+	}
+
+	Pending.push_back({ coord, GetPriority(coord) });
+	std::push_heap(Pending.begin(), Pending.end(), LoadsLater);
+}
+
+void ChunkScheduler::Remove(const ChunkCoord& coord)
+{
+	PendingSet.Erase(coord);
+}
+
+void ChunkScheduler::Clear()
+{
+	Pending.clear();
+	PendingSet.Clear();
+}
+
+void ChunkScheduler::UpdateView(const glm::ivec3& camChunk, const glm::vec3& viewDirection)
+{
+	if (glm::dot(viewDirection, viewDirection) < 1e-6f)
+	{
+		return;
+	}
+
+	const glm::vec3 direction = glm::normalize(viewDirection);
+	const glm::ivec3 drift = glm::abs(camChunk - CamChunk);
+	if (glm::max(drift.x, glm::max(drift.y, drift.z)) < ReprioritiseDrift && glm::dot(direction, ViewDirection) >= ReprioritiseDot)
+	{
+		return;
+	}
+
+	CamChunk = camChunk;
+	ViewDirection = direction;
+	Reprioritise();
+}
+
+void ChunkScheduler::Tick(double deltaTime, uint32_t numCompleted)
+{
+	CompletedThisSecond += numCompleted;
+	SecondTimer += deltaTime;
+
+	if (SecondTimer >= 1.0)
+	{
+		ChunksPerSecond = static_cast<float>(CompletedThisSecond / SecondTimer);
+		CompletedThisSecond = 0;
+		SecondTimer = 0.0;
+	}
+}
+
+bool ChunkScheduler::LoadsLater(const FPendingChunk& a, const FPendingChunk& b)
+{
+	return a.Priority > b.Priority;
+}
+
+float ChunkScheduler::GetPriority(const ChunkCoord& coord) const
+{
+	const glm::vec3 offset = glm::vec3(coord.ToIVec3() - CamChunk);
+	const float distance = glm::length(offset);
+	if (distance < 1e-3f)
+	{
+		return 0.0f;
+	}
+
+	// Straight ahead counts at its real distance, straight behind at twice it
+	const float facing = glm::dot(offset / distance, ViewDirection);
+	return distance * (1.5f - 0.5f * facing);
+}
+
+void ChunkScheduler::Reprioritise()
+{
+	std::erase_if(Pending, [this](const FPendingChunk& chunk)
+	{
+		return !PendingSet.Contains(chunk.Coord);
+	});
+
+	for (FPendingChunk& chunk : Pending)
+	{
+		chunk.Priority = GetPriority(chunk.Coord);
+	}
+
+	std::make_heap(Pending.begin(), Pending.end(), LoadsLater);
+}
+
+bool ChunkScheduler::PopNext(ChunkCoord* coord)
+{
+	while (!Pending.empty())
+	{
+		std::pop_heap(Pending.begin(), Pending.end(), LoadsLater);
+
+		const ChunkCoord next = Pending.back().Coord;
+		Pending.pop_back();
+
+		if (PendingSet.Erase(next))
+		{
+			*coord = next;
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ChunkCoord.h"
+#include "../FlatHashMap.h"
+
+/**
+ * Decides which chunks to load next and how many generation jobs may run at once.
+ * Pending chunks are kept in a heap ordered by distance to the camera, with chunks behind the camera pushed back,
+ * so the pool always works on the most visible missing chunks first.
+ *
+ * The pending set is edited incrementally as the camera moves: Add ignores chunks that are already pending, and Remove
+ * only unmarks a chunk, whose stale heap entry is skipped when popped or dropped at the next re-sort.
+ */
+class ChunkScheduler
+{
+public:
+
+	explicit ChunkScheduler(uint32_t InMaxInFlight);
+
+	/** Queues a chunk unless it is already pending */
+	void Add(const ChunkCoord& coord);
+
+	/** Drops a chunk from the pending set if it has not been submitted yet */
+	void Remove(const ChunkCoord& coord);
+
+	void Clear();
+
+	/**
+	 * Re-sorts the pending heap when the camera turned far enough to change what is in view, or drifted far enough
+	 * from where the heap was last sorted. A one-chunk move changes every distance by at most one, so it does not.
+	 */
+	void UpdateView(const glm::ivec3& camChunk, const glm::vec3& viewDirection);
+
+	/**
+	 * Pops chunks in priority order and calls submit(coord) until maxInFlight jobs are running or nothing is pending.
+	 * submit returns false for coordinates it skipped (already loaded or out of range), which don't count as jobs.
+	 */
+	template <typename TSubmitFunction>
+	void Dispatch(uint32_t numInFlight, TSubmitFunction&& submit)
+	{
+		InFlight = numInFlight;
+		ChunkCoord coord;
+		while (InFlight < MaxInFlight && PopNext(&coord))
+		{
+			if (submit(coord))
+			{
+				InFlight++;
+				Submitted++;
+			}
+		}
+	}
+
+	/** Records chunks that finished loading this frame and updates the chunks per second counter */
+	void Tick(double deltaTime, uint32_t numCompleted);
+
+	void SetMaxInFlight(uint32_t InMaxInFlight) { MaxInFlight = InMaxInFlight > 0 ? InMaxInFlight : 1; }
+	uint32_t GetMaxInFlight() const { return MaxInFlight; }
+
+	size_t GetQueueDepth() const { return PendingSet.Size(); }
+	uint32_t GetInFlight() const { return InFlight; }
+	uint64_t GetNumSubmitted() const { return Submitted; }
+	float GetChunksPerSecond() const { return ChunksPerSecond; }
+
+private:
+
+	struct FPendingChunk
+	{
+		ChunkCoord Coord;
+
+		/** Lower loads first */
+		float Priority;
+	};
+
+	static bool LoadsLater(const FPendingChunk& a, const FPendingChunk& b);
+
+	float GetPriority(const ChunkCoord& coord) const;
+	void Reprioritise();
+
+	/** Pops the highest priority chunk that is still pending. Returns false once nothing is. */
+	bool PopNext(ChunkCoord* coord);
+
+private:
+
+	/** Min-heap on Priority. May hold entries that were removed since they were pushed. */
+	std::vector<FPendingChunk> Pending;
+
+	/** Chunks that are really pending */
+	TFlatHashMap<ChunkCoord, uint8_t> PendingSet;
+
+	/** Camera chunk and view direction the heap was last sorted for */
+	glm::ivec3 CamChunk = glm::ivec3(0);
+	glm::vec3 ViewDirection = glm::vec3(0.0f, 0.0f, -1.0f);
+
+	uint32_t MaxInFlight;
+	uint32_t InFlight = 0;
+	uint64_t Submitted = 0;
+
+	uint32_t CompletedThisSecond = 0;
+	double SecondTimer = 0.0;
+	float ChunksPerSecond = 0.0f;
+};
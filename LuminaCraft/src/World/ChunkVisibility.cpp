@@ -0,0 +1,304 @@
+#include "ChunkVisibility.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "ChunkVolume.h"
+#include "../Renderer/Frustum.h"
+
+namespace
+{
+	constexpr uint8_t AllFaces = (1 << FChunkConnectivity::NumFaces) - 1;
+
+	/** Step to the neighbouring chunk across each EChunkFace */
+	const glm::ivec3 FaceOffsets[FChunkConnectivity::NumFaces] =
+	{
+		{ -1, 0, 0 }, { 1, 0, 0 },
+		{ 0, -1, 0 }, { 0, 1, 0 },
+		{ 0, 0, -1 }, { 0, 0, 1 }
+	};
+
+	uint8_t FacesTouched(int x, int y, int z, int chunkSize)
+	{
+		const int last = chunkSize - 1;
+		return static_cast<uint8_t>((x == 0) << static_cast<int>(EChunkFace::NegX) | (x == last) << static_cast<int>(EChunkFace::PosX) |
+									(y == 0) << static_cast<int>(EChunkFace::NegY) | (y == last) << static_cast<int>(EChunkFace::PosY) |
+									(z == 0) << static_cast<int>(EChunkFace::NegZ) | (z == last) << static_cast<int>(EChunkFace::PosZ));
+	}
+
+	/** Voxel coordinates packed 10 bits per axis for the flood fill stack */
+	uint32_t PackVoxel(int x, int y, int z) { return (x << 20) | (y << 10) | z; }
+
+	/** Bit (x * 4 + z) * 4 + y for every occluder cell in [min, max) */
+	uint64_t CellMask(const glm::ivec3& min, const glm::ivec3& max)
+	{
+		uint64_t mask = 0;
+		for (int x = min.x; x < max.x; x++)
+		{
+			for (int z = min.z; z < max.z; z++)
+			{
+				for (int y = min.y; y < max.y; y++)
+				{
+					mask |= uint64_t(1) << ((x * FChunkOccluders::CellsPerAxis + z) * FChunkOccluders::CellsPerAxis + y);
+				}
+			}
+		}
+		return mask;
+	}
+}
+
+FChunkConnectivity FChunkConnectivity::All()
+{
+	FChunkConnectivity connectivity;
+	connectivity.ConnectFaces(AllFaces);
+	return connectivity;
+}
+
+void FChunkConnectivity::ConnectFaces(uint8_t faceMask)
+{
+	for (int from = 0; from < NumFaces; from++)
+	{
+		if (faceMask & (1 << from))
+		{
+			Bits |= static_cast<uint64_t>(faceMask) << (from * NumFaces);
+		}
+	}
+}
+
+FChunkConnectivity FChunkConnectivity::Compute(const std::vector<BlockID>& blockData, int chunkSize)
+{
+	FChunkConnectivity connectivity;
+
+	thread_local std::vector<uint8_t> visited;
+	thread_local std::vector<uint32_t> stack;
+	visited.assign(blockData.size(), 0);
+
+	// Pockets that touch no face connect nothing, so fills only need to start from air on the chunk's shell
+	for (int x = 0; x < chunkSize; x++)
+	{
+		for (int z = 0; z < chunkSize; z++)
+		{
+			const bool bInteriorColumn = x > 0 && x < chunkSize - 1 && z > 0 && z < chunkSize - 1;
+
+			for (int y = 0; y < chunkSize; y += (bInteriorColumn && y == 0) ? chunkSize - 1 : 1)
+			{
+				const size_t seed = ChunkVolume::Index(x, y, z, chunkSize);
+				if (blockData[seed] != 0 || visited[seed])
+				{
+					continue;
+				}
+
+				uint8_t faceMask = 0;
+				visited[seed] = 1;
+				stack.push_back(PackVoxel(x, y, z));
+
+				while (!stack.empty())
+				{
+					const uint32_t packed = stack.back();
+					stack.pop_back();
+
+					const int vx = packed >> 20;
+					const int vy = (packed >> 10) & 0x3FF;
+					const int vz = packed & 0x3FF;
+					faceMask |= FacesTouched(vx, vy, vz, chunkSize);
+
+					for (const glm::ivec3& offset : FaceOffsets)
+					{
+						const glm::ivec3 next(vx + offset.x, vy + offset.y, vz + offset.z);
+						if (!ChunkVolume::Contains(next, chunkSize))
+						{
+							continue;
+						}
+
+						const size_t index = ChunkVolume::Index(next, chunkSize);
+						if (blockData[index] == 0 && !visited[index])
+						{
+							visited[index] = 1;
+							stack.push_back(PackVoxel(next.x, next.y, next.z));
+						}
+					}
+				}
+
+				connectivity.ConnectFaces(faceMask);
+
+				// One pocket reaching every face already connects everything
+				if (faceMask == AllFaces)
+				{
+					return connectivity;
+				}
+			}
+		}
+	}
+
+	return connectivity;
+}
+
+FChunkOccluders FChunkOccluders::Solid()
+{
+	FChunkOccluders occluders;
+	occluders.Boxes[0] = { { 0, 0, 0 }, { CellsPerAxis, CellsPerAxis, CellsPerAxis } };
+	occluders.NumBoxes = 1;
+	return occluders;
+}
+
+FChunkOccluders FChunkOccluders::Compute(const std::vector<BlockID>& blockData, int chunkSize)
+{
+	FChunkOccluders occluders;
+	if (chunkSize % CellsPerAxis != 0)
+	{
+		return occluders;
+	}
+
+	const int cellSize = chunkSize / CellsPerAxis;
+
+	uint64_t solidCells = 0;
+	for (int cellX = 0; cellX < CellsPerAxis; cellX++)
+	{
+		for (int cellZ = 0; cellZ < CellsPerAxis; cellZ++)
+		{
+			for (int cellY = 0; cellY < CellsPerAxis; cellY++)
+			{
+				bool bSolid = true;
+				for (int x = cellX * cellSize; x < (cellX + 1) * cellSize && bSolid; x++)
+				{
+					for (int z = cellZ * cellSize; z < (cellZ + 1) * cellSize && bSolid; z++)
+					{
+						for (int y = cellY * cellSize; y < (cellY + 1) * cellSize; y++)
+						{
+							if (blockData[ChunkVolume::Index(x, y, z, chunkSize)] == 0)
+							{
+								bSolid = false;
+								break;
+							}
+						}
+					}
+				}
+
+				if (bSolid)
+				{
+					solidCells |= CellMask({ cellX, cellY, cellZ }, { cellX + 1, cellY + 1, cellZ + 1 });
+				}
+			}
+		}
+	}
+
+	// Grow a box from the first unclaimed solid cell along y, then x, then z, for as long as whole layers stay solid
+	FCellBox candidates[CellsPerAxis * CellsPerAxis * CellsPerAxis];
+	int numCandidates = 0;
+
+	uint64_t unclaimed = solidCells;
+	while (unclaimed)
+	{
+		const int cell = std::countr_zero(unclaimed);
+		const glm::ivec3 min(cell >> 4, cell & 3, (cell >> 2) & 3);
+		glm::ivec3 max = min + 1;
+
+		for (const int axis : { 1, 0, 2 })
+		{
+			while (max[axis] < CellsPerAxis)
+			{
+				glm::ivec3 layerMin = min;
+				glm::ivec3 layerMax = max;
+				layerMin[axis] = max[axis];
+				layerMax[axis] = max[axis] + 1;
+
+				const uint64_t layer = CellMask(layerMin, layerMax);
+				if ((unclaimed & layer) != layer)
+				{
+					break;
+				}
+				max[axis]++;
+			}
+		}
+
+		unclaimed &= ~CellMask(min, max);
+		candidates[numCandidates++] = { { uint8_t(min.x), uint8_t(min.y), uint8_t(min.z) }, { uint8_t(max.x), uint8_t(max.y), uint8_t(max.z) } };
+	}
+
+	// Small boxes hide little and still cost a polygon each
+	auto volume = [](const FCellBox& box) { return (box.Max[0] - box.Min[0]) * (box.Max[1] - box.Min[1]) * (box.Max[2] - box.Min[2]); };
+	std::stable_sort(candidates, candidates + numCandidates, [&](const FCellBox& a, const FCellBox& b) { return volume(a) > volume(b); });
+
+	occluders.NumBoxes = static_cast<uint8_t>(std::min(numCandidates, MaxBoxes));
+	std::copy(candidates, candidates + occluders.NumBoxes, occluders.Boxes);
+	return occluders;
+}
+
+void FChunkOccluders::AppendBoxes(const glm::vec3& chunkWorldPos, int chunkSize, std::vector<FOccluderBox>* boxes) const
+{
+	const float cellSize = static_cast<float>(chunkSize) / CellsPerAxis;
+	for (int i = 0; i < NumBoxes; i++)
+	{
+		const FCellBox& box = Boxes[i];
+		boxes->push_back({ chunkWorldPos + glm::vec3(box.Min[0], box.Min[1], box.Min[2]) * cellSize,
+						   chunkWorldPos + glm::vec3(box.Max[0], box.Max[1], box.Max[2]) * cellSize });
+	}
+}
+
+void ChunkVisibilityGraph::Reset(const glm::ivec3& InRadius)
+{
+	Radius = InRadius;
+	Extent = 2 * InRadius + 1;
+	Visited.assign(static_cast<size_t>(Extent.x) * Extent.y * Extent.z, 0);
+	Stamp = 0;
+	NumReached = 0;
+}
+
+bool ChunkVisibilityGraph::BeginSearch(const glm::ivec3& startChunk, const glm::ivec3& boxCenter)
+{
+	BoxCenter = boxCenter;
+	Queue.clear();
+	NumReached = 0;
+
+	// Stamps from before the counter wrapped could match again
+	if (++Stamp == 0)
+	{
+		std::fill(Visited.begin(), Visited.end(), 0);
+		Stamp = 1;
+	}
+
+	const int index = BoxIndex(startChunk);
+	if (index < 0)
+	{
+		return false;
+	}
+
+	Visited[index] = Stamp;
+	Queue.push_back({ startChunk, FChunkConnectivity::NumFaces, 0 });
+	return true;
+}
+
+void ChunkVisibilityGraph::Expand(const Frustum& frustum, const FNode& node, const FChunkConnectivity& connectivity, int chunkSize)
+{
+	for (int exit = 0; exit < FChunkConnectivity::NumFaces; exit++)
+	{
+		// Stepping back against a direction already taken would let the path bend around corners no sight line can
+		const int opposite = exit ^ 1;
+		if (node.Directions & (1 << opposite))
+		{
+			continue;
+		}
+
+		// The camera's own chunk can be left through any face
+		if (node.EntryFace != FChunkConnectivity::NumFaces && !connectivity.Connects(static_cast<EChunkFace>(node.EntryFace), static_cast<EChunkFace>(exit)))
+		{
+			continue;
+		}
+
+		const glm::ivec3 neighbour = node.ChunkPos + FaceOffsets[exit];
+		const int index = BoxIndex(neighbour);
+		if (index < 0 || Visited[index] == Stamp)
+		{
+			continue;
+		}
+
+		const glm::vec3 boxMin = glm::vec3(neighbour * chunkSize);
+		if (!frustum.boxInFrustum(boxMin, boxMin + static_cast<float>(chunkSize)))
+		{
+			continue;
+		}
+
+		Visited[index] = Stamp;
+		Queue.push_back({ neighbour, static_cast<uint8_t>(opposite), static_cast<uint8_t>(node.Directions | (1 << exit)) });
+	}
+}
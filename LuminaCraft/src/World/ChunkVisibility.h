@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BlockStorage.h"
+#include "../Renderer/OcclusionBuffer.h"
+
+class Frustum;
+
+/** The six faces of a chunk. Opposite faces differ only in the lowest bit. */
+enum class EChunkFace : uint8_t
+{
+	NegX, PosX,
+	NegY, PosY,
+	NegZ, PosZ
+};
+
+/**
+ * Which pairs of a chunk's faces are joined by a path through its air voxels, as a symmetric 6x6 bit matrix.
+ * Computed once per chunk when it is meshed and used by ChunkVisibilityGraph to decide which chunks a line of sight
+ * can pass through.
+ */
+struct FChunkConnectivity
+{
+	static constexpr int NumFaces = 6;
+
+	/** Every face sees every other face, used for air and for chunks whose contents are not known yet */
+	static FChunkConnectivity All();
+
+	/** Flood fills the air voxels of a decoded chunk volume and records which faces each air pocket touches */
+	static FChunkConnectivity Compute(const std::vector<BlockID>& blockData, int chunkSize);
+
+	bool Connects(EChunkFace from, EChunkFace to) const
+	{
+		return (Bits >> (static_cast<int>(from) * NumFaces + static_cast<int>(to))) & 1;
+	}
+
+	/** Joins every pair of the faces in faceMask, a bit per EChunkFace */
+	void ConnectFaces(uint8_t faceMask);
+
+	/** Bit from * 6 + to is set if from and to are connected */
+	uint64_t Bits = 0;
+};
+
+/**
+ * Boxes of a chunk that are solid all the way through, drawn into the occlusion buffer to hide chunks behind them.
+ * The chunk is split into 4x4x4 cells and runs of fully solid cells are merged into boxes; only the largest few are kept.
+ */
+struct FChunkOccluders
+{
+	static constexpr int CellsPerAxis = 4;
+	static constexpr int MaxBoxes = 8;
+
+	/** Box in cells, max exclusive */
+	struct FCellBox
+	{
+		uint8_t Min[3];
+		uint8_t Max[3];
+	};
+
+	/** The whole chunk as one box, for chunks of a single solid block */
+	static FChunkOccluders Solid();
+
+	/** Finds the fully solid cells of a decoded chunk volume and merges them into boxes */
+	static FChunkOccluders Compute(const std::vector<BlockID>& blockData, int chunkSize);
+
+	/** Appends the boxes in world space for a chunk whose minimum corner is chunkWorldPos */
+	void AppendBoxes(const glm::vec3& chunkWorldPos, int chunkSize, std::vector<FOccluderBox>* boxes) const;
+
+	FCellBox Boxes[MaxBoxes];
+	uint8_t NumBoxes = 0;
+};
+
+/**
+ * Picks the chunks a line of sight from the camera could reach, by a breadth-first search from the camera's chunk that
+ * only steps through a chunk between faces its air connects. The search never steps back against a direction it has
+ * already moved in, so paths stay roughly straight, and skips chunks outside the frustum. Chunks it never reaches are
+ * hidden behind solid terrain and need not be drawn.
+ *
+ * The search covers a fixed box of chunks; visit marks are stamped with a search counter so nothing is cleared per frame.
+ */
+class ChunkVisibilityGraph
+{
+public:
+
+	/** Sizes the search box to [center - radius, center + radius], matching the loaded chunk grid */
+	void Reset(const glm::ivec3& InRadius);
+
+	/**
+	 * Searches from startChunk within the box around boxCenter. getConnectivity(chunkPos) returns the connectivity of a
+	 * chunk in the box; chunks that are not loaded yet should report FChunkConnectivity::All().
+	 * Returns false if startChunk is outside the box, in which case the search says nothing about what is hidden.
+	 */
+	template <typename TGetConnectivity>
+	bool Search(const Frustum& frustum, const glm::ivec3& startChunk, const glm::ivec3& boxCenter, int chunkSize, TGetConnectivity&& getConnectivity);
+
+	/** Whether the last successful search reached chunkPos */
+	bool IsReachable(const glm::ivec3& chunkPos) const
+	{
+		const int index = BoxIndex(chunkPos);
+		return index >= 0 && Visited[index] == Stamp;
+	}
+
+	/** Stats of the last search */
+	size_t GetNumReached() const { return NumReached; }
+
+private:
+
+	struct FNode
+	{
+		glm::ivec3 ChunkPos;
+
+		/** Face the search entered this chunk through, or NumFaces for the start chunk */
+		uint8_t EntryFace;
+
+		/** Bit per EChunkFace the path has stepped out through so far */
+		uint8_t Directions;
+	};
+
+	/** Index of chunkPos in Visited, or -1 if it is outside the box */
+	int BoxIndex(const glm::ivec3& chunkPos) const
+	{
+		const glm::ivec3 local = chunkPos - BoxCenter + Radius;
+		if (glm::any(glm::lessThan(local, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(local, Extent)))
+		{
+			return -1;
+		}
+		return (local.x * Extent.z + local.z) * Extent.y + local.y;
+	}
+
+	/** Starts a new search; returns false if startChunk is outside the box */
+	bool BeginSearch(const glm::ivec3& startChunk, const glm::ivec3& boxCenter);
+
+	/** Visits the unvisited in-frustum neighbours of node that its connectivity lets a line of sight reach */
+	void Expand(const Frustum& frustum, const FNode& node, const FChunkConnectivity& connectivity, int chunkSize);
+
+private:
+
+	glm::ivec3 Radius = glm::ivec3(0);
+	glm::ivec3 Extent = glm::ivec3(0);
+	glm::ivec3 BoxCenter = glm::ivec3(0);
+
+	/** Stamp of the last search that visited each chunk of the box */
+	std::vector<uint32_t> Visited;
+	uint32_t Stamp = 0;
+
+	/** Every chunk reached by the current search, in the order it is expanded */
+	std::vector<FNode> Queue;
+
+	size_t NumReached = 0;
+};
+
+template <typename TGetConnectivity>
+bool ChunkVisibilityGraph::Search(const Frustum& frustum, const glm::ivec3& startChunk, const glm::ivec3& boxCenter, int chunkSize, TGetConnectivity&& getConnectivity)
+{
+	if (!BeginSearch(startChunk, boxCenter))
+	{
+		return false;
+	}
+
+	for (size_t head = 0; head < Queue.size(); head++)
+	{
+		const FNode node = Queue[head];
+		Expand(frustum, node, getConnectivity(node.ChunkPos), chunkSize);
+	}
+
+	NumReached = Queue.size();
+	return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/** Order in which a chunk's voxels are stored */
+enum class EVoxelLayout : uint8_t
+{
+	/** index = (x * chunkSize + z) * chunkSize + y. Vertical runs are contiguous. */
+	YColumn,
+
+	/** Bits of y, x and z interleaved (y lowest). Neighbours on every axis stay close; chunkSize must be a power of two. */
+	Morton
+};
+
+/**
+ * The one mapping from chunk-local voxel coordinates to an index into a chunk volume.
+ * Generation, meshing, neighbour slabs, block queries and edits all go through it, so the layout can change in one place.
+ */
+template <EVoxelLayout TLayout>
+struct TChunkVolume
+{
+	static constexpr EVoxelLayout Layout = TLayout;
+
+	static size_t Index(int x, int y, int z, int chunkSize)
+	{
+		if constexpr (TLayout == EVoxelLayout::Morton)
+		{
+			return SpreadBits(y) | (SpreadBits(x) << 1) | (SpreadBits(z) << 2);
+		}
+		else
+		{
+			return (static_cast<size_t>(x) * chunkSize + z) * chunkSize + y;
+		}
+	}
+
+	static size_t Index(const glm::ivec3& localPos, int chunkSize)
+	{
+		return Index(localPos.x, localPos.y, localPos.z, chunkSize);
+	}
+
+	static bool Contains(const glm::ivec3& localPos, int chunkSize)
+	{
+		return localPos.x >= 0 && localPos.x < chunkSize &&
+			   localPos.y >= 0 && localPos.y < chunkSize &&
+			   localPos.z >= 0 && localPos.z < chunkSize;
+	}
+
+private:
+
+	/** Spaces the low 10 bits of v two bits apart */
+	static size_t SpreadBits(int v)
+	{
+		uint32_t bits = static_cast<uint32_t>(v) & 0x3FF;
+		bits = (bits | (bits << 16)) & 0x030000FF;
+		bits = (bits | (bits << 8)) & 0x0300F00F;
+		bits = (bits | (bits << 4)) & 0x030C30C3;
+		bits = (bits | (bits << 2)) & 0x09249249;
+		return bits;
+	}
+};
+
+/** Layout used by every chunk volume in the game */
+using ChunkVolume = TChunkVolume<EVoxelLayout::YColumn>;
+
+
+/**
+ * A chunk volume with a one-voxel apron on every side holding the neighbouring chunks' touching layers, used as meshing
+ * input so a voxel's six neighbours are always fixed offsets away. Coordinates run from -1 to chunkSize on each axis.
+ * Always column ordered, whatever the layout of chunk volumes.
+ */
+struct PaddedChunkVolume
+{
+	static int Size(int chunkSize)
+	{
+		return chunkSize + 2;
+	}
+
+	static size_t NumVoxels(int chunkSize)
+	{
+		const size_t size = Size(chunkSize);
+		return size * size * size;
+	}
+
+	static size_t Index(int x, int y, int z, int chunkSize)
+	{
+		const size_t size = Size(chunkSize);
+		return (static_cast<size_t>(x + 1) * size + (z + 1)) * size + (y + 1);
+	}
+
+	static size_t Index(const glm::ivec3& localPos, int chunkSize)
+	{
+		return Index(localPos.x, localPos.y, localPos.z, chunkSize);
+	}
+
+	/** Index distance of a step between voxels */
+	static ptrdiff_t Offset(const glm::ivec3& step, int chunkSize)
+	{
+		const ptrdiff_t size = Size(chunkSize);
+		return (step.x * size + step.z) * size + step.y;
+	}
+};
@@ -0,0 +1,29 @@
+#include "ColumnCache.h"
+
+#include "WorldGenerator.h"
+
+ColumnCache::ColumnCache(std::shared_ptr<const WorldGenerator> InGenerator, int InChunkSize, size_t InMaxEntries)
+	: Generator(std::move(InGenerator)), ChunkSize(InChunkSize),
+	  Cache(InMaxEntries, [](const FColumnData& Column) { return Column.SurfaceHeight.size() * sizeof(int32_t) + Column.Biome.size(); })
+{
+}
+
+ColumnCache::~ColumnCache()
+{
+}
+
+std::shared_ptr<const FColumnData> ColumnCache::GetOrGenerate(int chunkX, int chunkZ)
+{
+	return Cache.GetOrCreate(ChunkCoord(chunkX, 0, chunkZ), [this, chunkX, chunkZ]
+	{
+		auto Column = std::make_shared<FColumnData>();
+		Generator->GenerateColumn(chunkX, chunkZ, ChunkSize, Column.get());
+
+		return std::shared_ptr<const FColumnData>(std::move(Column));
+	});
+}
+
+void ColumnCache::Release(int chunkX, int chunkZ)
+{
+	Cache.Demote(ChunkCoord(chunkX, 0, chunkZ));
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+
+#include "SharedCache.h"
+#include "ChunkCoord.h"
+
+class WorldGenerator;
+struct FColumnData;
+
+/**
+ * Shares each chunk column's surface height and biome between every chunk stacked in it.
+ * Columns of unloaded chunks are demoted so they are evicted first.
+ */
+class ColumnCache
+{
+public:
+
+	ColumnCache(std::shared_ptr<const WorldGenerator> InGenerator, int InChunkSize, size_t InMaxEntries);
+	~ColumnCache();
+
+	/** Returns the column data, generating it on the calling thread if no other job has */
+	std::shared_ptr<const FColumnData> GetOrGenerate(int chunkX, int chunkZ);
+
+	/** Called when the last loaded chunk in this column unloads, making the column the next to be evicted */
+	void Release(int chunkX, int chunkZ);
+
+	float GetHitRate() const { return Cache.GetHitRate(); }
+	size_t GetNumEntries() const { return Cache.GetNumEntries(); }
+	size_t GetBytes() const { return Cache.GetBytes(); }
+
+private:
+
+	std::shared_ptr<const WorldGenerator> Generator;
+	int ChunkSize;
+
+	/** Keyed by the column's chunk coordinate with y = 0 */
+	TSharedCache<ChunkCoord, FColumnData> Cache;
+};
@@ -0,0 +1,704 @@
+#include "Noise.h"
+
+// Fixed-width integer types instead of long, and no srand/rand. Permutations are built by MakePermutation below.
+#define OSN_USE_CSTDINT
+#include <OpenSimplexNoise.hh>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Vector width is picked at compile time from the target architecture flags (/arch:AVX2, -mavx2, ...)
+#if defined(__AVX2__)
+#define NOISE_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOISE_SIMD_SSE2
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define NOISE_SIMD_SSE41
+#include <smmintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#endif
+
+// Same float constants the scalar OSN::Noise<2>::eval<float> computes
+static const float Stretch2D = static_cast<float>((1.0 / std::sqrt(2.0 + 1.0) - 1.0) * 0.5);
+static const float Squish2D = static_cast<float>((std::sqrt(2.0 + 1.0) - 1.0) * 0.5);
+static const float Norm2D = static_cast<float>(1.0 / 47.0);
+
+// Copy of the private OSN::Noise<2>::gradients table
+static const float Gradients2D[16] =
+{
+	 5,  2,    2,  5,
+	-5,  2,   -2,  5,
+	 5, -2,    2, -5,
+	-5, -2,   -2, -5,
+};
+
+// Same float constants the scalar OSN::Noise<3>::eval<float> computes
+static const float Stretch3D = static_cast<float>(-1.0 / 6.0);
+static const float Squish3D = static_cast<float>(1.0 / 3.0);
+static const float Norm3D = static_cast<float>(1.0 / 103.0);
+
+// Copy of the private OSN::Noise<3>::gradients table
+static const float Gradients3D[72] =
+{
+	-11,  4,  4,   -4, 11,  4,   -4,  4, 11,   11,  4,  4,    4, 11,  4,    4,  4, 11,
+	-11, -4,  4,   -4,-11,  4,   -4, -4, 11,   11, -4,  4,    4,-11,  4,    4, -4, 11,
+	-11,  4, -4,   -4, 11, -4,   -4,  4,-11,   11,  4, -4,    4, 11, -4,    4,  4,-11,
+	-11, -4, -4,   -4,-11, -4,   -4, -4,-11,   11, -4, -4,    4,-11, -4,    4, -4,-11,
+};
+
+/**
+ * The permutation OSN's int64_t seed constructor builds, from the same 64-bit LCG run in uint64_t.
+ * OSN's version relies on signed overflow wrapping, which is undefined behaviour; this gives the same bits without it.
+ */
+static std::array<int, 256> MakePermutation(int64_t seed)
+{
+	// Knuth's MMIX constants, as in OSN::NoiseBase::LCG_STEP
+	constexpr uint64_t Multiplier = 6364136223846793005ULL;
+	constexpr uint64_t Increment = 1442695040888963407ULL;
+
+	uint64_t state = static_cast<uint64_t>(seed);
+	const auto step = [&state]() { state = state * Multiplier + Increment; };
+
+	int source[256];
+	for (int i = 0; i < 256; i++)
+	{
+		source[i] = i;
+	}
+
+	step();
+	step();
+	step();
+
+	std::array<int, 256> perm;
+	for (int i = 255; i >= 0; i--)
+	{
+		step();
+
+		// OSN takes the remainder of the signed value, so the wrapped sum is reinterpreted before dividing
+		int r = static_cast<int>(static_cast<int64_t>(state + 31) % (i + 1));
+		if (r < 0)
+		{
+			r += i + 1;
+		}
+		perm[i] = source[r];
+		source[r] = source[i];
+	}
+
+	return perm;
+}
+
+struct Noise2D::FImpl : public OSN::Noise<2>
+{
+	FImpl(int64_t InSeed) : OSN::Noise<2>(MakePermutation(InSeed).data()) {}
+
+	const int* GetPerm() const { return perm; }
+};
+
+struct Noise3D::FImpl : public OSN::Noise<3>
+{
+	FImpl(int64_t InSeed) : OSN::Noise<3>(MakePermutation(InSeed).data())
+	{
+		// OSN keeps its own copy private; this is the same mapping
+		for (int i = 0; i < 256; i++)
+		{
+			PermGradIndex[i] = (perm[i] % (72 / 3)) * 3;
+		}
+	}
+
+	const int* GetPerm() const { return perm; }
+
+	int PermGradIndex[256];
+};
+
+#if defined(NOISE_SIMD_AVX2) || defined(NOISE_SIMD_SSE2)
+
+#if defined(NOISE_SIMD_AVX2)
+struct FNoiseVector
+{
+	static constexpr int Width = 8;
+
+	using FFloat = __m256;
+	using FInt = __m256i;
+
+	static FFloat Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, FFloat v) { _mm256_storeu_ps(p, v); }
+	static void StoreInt(int* p, FInt v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+	static FFloat Set(float f) { return _mm256_set1_ps(f); }
+
+	static FFloat Add(FFloat a, FFloat b) { return _mm256_add_ps(a, b); }
+	static FFloat Sub(FFloat a, FFloat b) { return _mm256_sub_ps(a, b); }
+	static FFloat Mul(FFloat a, FFloat b) { return _mm256_mul_ps(a, b); }
+	static FFloat Max(FFloat a, FFloat b) { return _mm256_max_ps(a, b); }
+	static FFloat Or(FFloat a, FFloat b) { return _mm256_or_ps(a, b); }
+	static FFloat And(FFloat a, FFloat b) { return _mm256_and_ps(a, b); }
+	static FFloat Xor(FFloat a, FFloat b) { return _mm256_xor_ps(a, b); }
+
+	/** a and not b */
+	static FFloat AndNot(FFloat a, FFloat b) { return _mm256_andnot_ps(b, a); }
+
+	static FFloat Equal(FFloat a, FFloat b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+	static FFloat Less(FFloat a, FFloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static FFloat Greater(FFloat a, FFloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static FFloat LessEqual(FFloat a, FFloat b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+
+	/** mask ? a : b per lane */
+	static FFloat Select(FFloat mask, FFloat a, FFloat b) { return _mm256_blendv_ps(b, a, mask); }
+	static FInt Select(FFloat mask, FInt a, FInt b) { return _mm256_blendv_epi8(b, a, _mm256_castps_si256(mask)); }
+
+	static FInt AddInt(FInt a, int b) { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+	static FInt AddInt(FInt a, FInt b) { return _mm256_add_epi32(a, b); }
+	static FFloat ToFloat(FInt v) { return _mm256_cvtepi32_ps(v); }
+
+	/** Truncates; only used on whole numbers */
+	static FInt ToInt(FFloat v) { return _mm256_cvttps_epi32(v); }
+
+	/** Truncates and steps negative values down by one, exactly like OSN's fastFloori (including -2.0 -> -3) */
+	static FInt FastFloor(FFloat v)
+	{
+		const __m256i truncated = _mm256_cvttps_epi32(v);
+		const __m256i negative = _mm256_castps_si256(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LT_OQ));
+		return _mm256_add_epi32(truncated, negative);
+	}
+};
+#else
+struct FNoiseVector
+{
+	static constexpr int Width = 4;
+
+	using FFloat = __m128;
+	using FInt = __m128i;
+
+	static FFloat Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, FFloat v) { _mm_storeu_ps(p, v); }
+	static void StoreInt(int* p, FInt v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+	static FFloat Set(float f) { return _mm_set1_ps(f); }
+
+	static FFloat Add(FFloat a, FFloat b) { return _mm_add_ps(a, b); }
+	static FFloat Sub(FFloat a, FFloat b) { return _mm_sub_ps(a, b); }
+	static FFloat Mul(FFloat a, FFloat b) { return _mm_mul_ps(a, b); }
+	static FFloat Max(FFloat a, FFloat b) { return _mm_max_ps(a, b); }
+	static FFloat Or(FFloat a, FFloat b) { return _mm_or_ps(a, b); }
+	static FFloat And(FFloat a, FFloat b) { return _mm_and_ps(a, b); }
+	static FFloat Xor(FFloat a, FFloat b) { return _mm_xor_ps(a, b); }
+
+	/** a and not b */
+	static FFloat AndNot(FFloat a, FFloat b) { return _mm_andnot_ps(b, a); }
+
+	static FFloat Equal(FFloat a, FFloat b) { return _mm_cmpeq_ps(a, b); }
+	static FFloat Less(FFloat a, FFloat b) { return _mm_cmplt_ps(a, b); }
+	static FFloat Greater(FFloat a, FFloat b) { return _mm_cmpgt_ps(a, b); }
+	static FFloat LessEqual(FFloat a, FFloat b) { return _mm_cmple_ps(a, b); }
+
+	/** mask ? a : b per lane */
+#if defined(NOISE_SIMD_SSE41)
+	static FFloat Select(FFloat mask, FFloat a, FFloat b) { return _mm_blendv_ps(b, a, mask); }
+	static FInt Select(FFloat mask, FInt a, FInt b) { return _mm_blendv_epi8(b, a, _mm_castps_si128(mask)); }
+#else
+	static FFloat Select(FFloat mask, FFloat a, FFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+	static FInt Select(FFloat mask, FInt a, FInt b)
+	{
+		const __m128i m = _mm_castps_si128(mask);
+		return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+	}
+#endif
+
+	static FInt AddInt(FInt a, int b) { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+	static FInt AddInt(FInt a, FInt b) { return _mm_add_epi32(a, b); }
+	static FFloat ToFloat(FInt v) { return _mm_cvtepi32_ps(v); }
+
+	/** Truncates; only used on whole numbers */
+	static FInt ToInt(FFloat v) { return _mm_cvttps_epi32(v); }
+
+	/** Truncates and steps negative values down by one, exactly like OSN's fastFloori (including -2.0 -> -3) */
+	static FInt FastFloor(FFloat v)
+	{
+		const __m128i truncated = _mm_cvttps_epi32(v);
+		const __m128i negative = _mm_castps_si128(_mm_cmplt_ps(v, _mm_setzero_ps()));
+		return _mm_add_epi32(truncated, negative);
+	}
+};
+#endif
+
+using V = FNoiseVector;
+
+// Gradient lookups are gathered per lane; the dot product itself stays in vector registers
+static V::FFloat Extrapolate2D(const int* perm, V::FInt xsb, V::FInt ysb, V::FFloat dx, V::FFloat dy)
+{
+	alignas(32) int xs[V::Width];
+	alignas(32) int ys[V::Width];
+	alignas(32) float gx[V::Width];
+	alignas(32) float gy[V::Width];
+
+	V::StoreInt(xs, xsb);
+	V::StoreInt(ys, ysb);
+
+	for (int lane = 0; lane < V::Width; lane++)
+	{
+		const unsigned int index = perm[(perm[xs[lane] & 0xFF] + ys[lane]) & 0xFF] & 0x0E;
+		gx[lane] = Gradients2D[index];
+		gy[lane] = Gradients2D[index + 1];
+	}
+
+	return V::Add(V::Mul(V::Load(gx), dx), V::Mul(V::Load(gy), dy));
+}
+
+/**
+ * V::Width lanes of OSN::Noise<2>::eval<float>. Every float operation is the scalar one in the same order;
+ * the branches on which triangle and which extra vertex are evaluated on both sides and blended.
+ */
+static void EvalNoise2DVector(const int* perm, const float* px, const float* py, float* out)
+{
+	const V::FFloat one = V::Set(1.0f);
+	const V::FFloat two = V::Set(2.0f);
+	const V::FFloat zero = V::Set(0.0f);
+	const V::FFloat squish = V::Set(Squish2D);
+	const V::FFloat squish2 = V::Set(Squish2D * 2.0f);
+
+	const V::FFloat x = V::Load(px);
+	const V::FFloat y = V::Load(py);
+
+	// Place input coordinates on a grid and floor to the rhombus super-cell origin
+	const V::FFloat stretchOffset = V::Mul(V::Add(x, y), V::Set(Stretch2D));
+	const V::FFloat xs = V::Add(x, stretchOffset);
+	const V::FFloat ys = V::Add(y, stretchOffset);
+
+	const V::FInt xsb = V::FastFloor(xs);
+	const V::FInt ysb = V::FastFloor(ys);
+	const V::FFloat xsbd = V::ToFloat(xsb);
+	const V::FFloat ysbd = V::ToFloat(ysb);
+
+	const V::FFloat squishOffset = V::Mul(V::Add(xsbd, ysbd), squish);
+	const V::FFloat dx0 = V::Sub(x, V::Add(xsbd, squishOffset));
+	const V::FFloat dy0 = V::Sub(y, V::Add(ysbd, squishOffset));
+
+	const V::FFloat xins = V::Sub(xs, xsbd);
+	const V::FFloat yins = V::Sub(ys, ysbd);
+	const V::FFloat inSum = V::Add(xins, yins);
+
+	// Contribution (1,0)
+	const V::FFloat dx1 = V::Sub(V::Sub(dx0, one), squish);
+	const V::FFloat dy1 = V::Sub(dy0, squish);
+	const V::FFloat m0 = V::Add(V::Mul(dx1, dx1), V::Mul(dy1, dy1));
+	const V::FFloat e0 = Extrapolate2D(perm, V::AddInt(xsb, 1), ysb, dx1, dy1);
+
+	// Contribution (0,1)
+	const V::FFloat dx2 = V::Sub(dx0, squish);
+	const V::FFloat dy2 = V::Sub(V::Sub(dy0, one), squish);
+	const V::FFloat m1 = V::Add(V::Mul(dx2, dx2), V::Mul(dy2, dy2));
+	const V::FFloat e1 = Extrapolate2D(perm, xsb, V::AddInt(ysb, 1), dx2, dy2);
+
+	const V::FFloat lowerTriangle = V::LessEqual(inSum, one);
+	const V::FFloat xGreater = V::Greater(xins, yins);
+
+	const V::FFloat dx0Minus1 = V::Sub(dx0, one);
+	const V::FFloat dy0Minus1 = V::Sub(dy0, one);
+	const V::FFloat dx11 = V::Sub(dx0Minus1, squish2);
+	const V::FFloat dy11 = V::Sub(dy0Minus1, squish2);
+
+	// Extra vertex inside the triangle at (0,0)
+	const V::FFloat lowerZins = V::Sub(one, inSum);
+	const V::FFloat lowerNear = V::Or(V::Greater(lowerZins, xins), V::Greater(lowerZins, yins));
+
+	const V::FInt lowerXsv = V::Select(lowerNear, V::Select(xGreater, V::AddInt(xsb, 1), V::AddInt(xsb, -1)), V::AddInt(xsb, 1));
+	const V::FInt lowerYsv = V::Select(lowerNear, V::Select(xGreater, V::AddInt(ysb, -1), V::AddInt(ysb, 1)), V::AddInt(ysb, 1));
+	const V::FFloat lowerDx = V::Select(lowerNear, V::Select(xGreater, dx0Minus1, V::Add(dx0, one)), dx11);
+	const V::FFloat lowerDy = V::Select(lowerNear, V::Select(xGreater, V::Add(dy0, one), dy0Minus1), dy11);
+
+	// Extra vertex inside the triangle at (1,1)
+	const V::FFloat upperZins = V::Sub(two, inSum);
+	const V::FFloat upperNear = V::Or(V::Less(upperZins, xins), V::Less(upperZins, yins));
+
+	const V::FInt upperXsv = V::Select(upperNear, V::Select(xGreater, V::AddInt(xsb, 2), xsb), xsb);
+	const V::FInt upperYsv = V::Select(upperNear, V::Select(xGreater, ysb, V::AddInt(ysb, 2)), ysb);
+	const V::FFloat upperDx = V::Select(upperNear, V::Select(xGreater, V::Sub(V::Sub(dx0, two), squish2), V::Sub(dx0, squish2)), dx0);
+	const V::FFloat upperDy = V::Select(upperNear, V::Select(xGreater, V::Sub(dy0, squish2), V::Sub(V::Sub(dy0, two), squish2)), dy0);
+
+	// Contribution (0,0) or (1,1)
+	const V::FInt xsb2 = V::Select(lowerTriangle, xsb, V::AddInt(xsb, 1));
+	const V::FInt ysb2 = V::Select(lowerTriangle, ysb, V::AddInt(ysb, 1));
+	const V::FFloat dx3 = V::Select(lowerTriangle, dx0, dx11);
+	const V::FFloat dy3 = V::Select(lowerTriangle, dy0, dy11);
+	const V::FFloat m2 = V::Add(V::Mul(dx3, dx3), V::Mul(dy3, dy3));
+	const V::FFloat e2 = Extrapolate2D(perm, xsb2, ysb2, dx3, dy3);
+
+	// Extra vertex
+	const V::FFloat dxExt = V::Select(lowerTriangle, lowerDx, upperDx);
+	const V::FFloat dyExt = V::Select(lowerTriangle, lowerDy, upperDy);
+	const V::FFloat m3 = V::Add(V::Mul(dxExt, dxExt), V::Mul(dyExt, dyExt));
+	const V::FFloat e3 = Extrapolate2D(perm, V::Select(lowerTriangle, lowerXsv, upperXsv), V::Select(lowerTriangle, lowerYsv, upperYsv), dxExt, dyExt);
+
+	const V::FFloat m[4] = { m0, m1, m2, m3 };
+	const V::FFloat e[4] = { e0, e1, e2, e3 };
+
+	V::FFloat value = zero;
+	for (int i = 0; i < 4; i++)
+	{
+		V::FFloat attenuation = V::Max(V::Sub(two, m[i]), zero);
+		attenuation = V::Mul(attenuation, attenuation);
+		value = V::Add(value, V::Mul(V::Mul(attenuation, attenuation), e[i]));
+	}
+
+	V::Store(out, V::Mul(value, V::Set(Norm2D)));
+}
+
+/** Three lane vectors, used both for lattice offsets and for OSN's point bit sets as a mask per axis */
+struct FNoiseVector3
+{
+	V::FFloat X;
+	V::FFloat Y;
+	V::FFloat Z;
+};
+
+static FNoiseVector3 Select3(V::FFloat mask, const FNoiseVector3& a, const FNoiseVector3& b)
+{
+	return { V::Select(mask, a.X, b.X), V::Select(mask, a.Y, b.Y), V::Select(mask, a.Z, b.Z) };
+}
+
+/** Per axis, mask ? a : b */
+static FNoiseVector3 SelectPerAxis(const FNoiseVector3& mask, const FNoiseVector3& a, const FNoiseVector3& b)
+{
+	return { V::Select(mask.X, a.X, b.X), V::Select(mask.Y, a.Y, b.Y), V::Select(mask.Z, a.Z, b.Z) };
+}
+
+/** Offset (x, y, z) in every lane */
+static FNoiseVector3 Offset3(float x, float y, float z)
+{
+	return { V::Set(x), V::Set(y), V::Set(z) };
+}
+
+/** One of OSN's point bit sets (1 = x, 2 = y, 4 = z) in every lane */
+static FNoiseVector3 Point3(int bits)
+{
+	const V::FFloat none = V::Set(0.0f);
+	const V::FFloat all = V::Equal(none, none);
+	return { bits & 1 ? all : none, bits & 2 ? all : none, bits & 4 ? all : none };
+}
+
+/** (2,0,0), (0,2,0) or (0,0,2) along the first axis in point */
+static FNoiseVector3 AlongFirstAxis(const FNoiseVector3& point)
+{
+	return Select3(point.X, Offset3(2, 0, 0), Select3(point.Y, Offset3(0, 2, 0), Offset3(0, 0, 2)));
+}
+
+/** (-1,1,1), (1,-1,1) or (1,1,-1) against the first axis missing from point */
+static FNoiseVector3 AgainstFirstMissingAxis(const FNoiseVector3& point)
+{
+	return Select3(point.X, Select3(point.Y, Offset3(1, 1, -1), Offset3(1, -1, 1)), Offset3(-1, 1, 1));
+}
+
+/** A lattice vertex of each lane's super-cell and the lane's position relative to it */
+struct FNoiseVertex3D
+{
+	V::FInt Xsv, Ysv, Zsv;
+	V::FFloat Dx, Dy, Dz;
+};
+
+/** Lane state every vertex of the 3D kernel is placed from */
+struct FNoiseCell3D
+{
+	const int* Perm;
+	const int* PermGradIndex;
+	V::FInt Xsb, Ysb, Zsb;
+	V::FFloat Dx0, Dy0, Dz0;
+
+	/**
+	 * The vertex at the super-cell origin plus offset. Every vertex the scalar walk visits is placed with
+	 * (d0 - offset) - squish * (offset.x + offset.y + offset.z), so one formula gives the scalar's bits for all of them.
+	 */
+	FNoiseVertex3D Vertex(const FNoiseVector3& offset) const
+	{
+		const V::FFloat squish = V::Mul(V::Set(Squish3D), V::Add(V::Add(offset.X, offset.Y), offset.Z));
+		return { V::AddInt(Xsb, V::ToInt(offset.X)), V::AddInt(Ysb, V::ToInt(offset.Y)), V::AddInt(Zsb, V::ToInt(offset.Z)),
+				 V::Sub(V::Sub(Dx0, offset.X), squish), V::Sub(V::Sub(Dy0, offset.Y), squish), V::Sub(V::Sub(Dz0, offset.Z), squish) };
+	}
+
+	/**
+	 * attenuation^4 * (gradient . d) for each lane's vertex, exactly as the scalar loop adds it up.
+	 * The gradient lookups of all the vertices are gathered in one pass so their dependent loads overlap.
+	 */
+	template <int NumVertices>
+	void Contributions(const FNoiseVertex3D (&vertices)[NumVertices], V::FFloat (&contributions)[NumVertices]) const
+	{
+		alignas(32) int xs[NumVertices][V::Width];
+		alignas(32) int ys[NumVertices][V::Width];
+		alignas(32) int zs[NumVertices][V::Width];
+		alignas(32) float gx[NumVertices][V::Width];
+		alignas(32) float gy[NumVertices][V::Width];
+		alignas(32) float gz[NumVertices][V::Width];
+
+		for (int vertex = 0; vertex < NumVertices; vertex++)
+		{
+			V::StoreInt(xs[vertex], vertices[vertex].Xsv);
+			V::StoreInt(ys[vertex], vertices[vertex].Ysv);
+			V::StoreInt(zs[vertex], vertices[vertex].Zsv);
+		}
+
+		for (int vertex = 0; vertex < NumVertices; vertex++)
+		{
+			for (int lane = 0; lane < V::Width; lane++)
+			{
+				const unsigned int index = PermGradIndex[(Perm[(Perm[xs[vertex][lane] & 0xFF] + ys[vertex][lane]) & 0xFF] + zs[vertex][lane]) & 0xFF];
+				gx[vertex][lane] = Gradients3D[index];
+				gy[vertex][lane] = Gradients3D[index + 1];
+				gz[vertex][lane] = Gradients3D[index + 2];
+			}
+		}
+
+		for (int vertex = 0; vertex < NumVertices; vertex++)
+		{
+			const FNoiseVertex3D& v = vertices[vertex];
+			const V::FFloat extrapolation = V::Add(V::Add(V::Mul(V::Load(gx[vertex]), v.Dx), V::Mul(V::Load(gy[vertex]), v.Dy)), V::Mul(V::Load(gz[vertex]), v.Dz));
+			const V::FFloat m = V::Add(V::Add(V::Mul(v.Dx, v.Dx), V::Mul(v.Dy, v.Dy)), V::Mul(v.Dz, v.Dz));
+
+			V::FFloat attenuation = V::Max(V::Sub(V::Set(2.0f), m), V::Set(0.0f));
+			attenuation = V::Mul(attenuation, attenuation);
+			contributions[vertex] = V::Mul(V::Mul(attenuation, attenuation), extrapolation);
+		}
+	}
+};
+
+/**
+ * V::Width lanes of OSN::Noise<3>::eval<float>. The scalar walk branches on which of three cells the point is in and
+ * which two extra vertices that cell needs; here each decision is a mask, the chosen vertices' offsets are blended,
+ * and each contribution is computed once and added in the scalar's slot order.
+ */
+static void EvalNoise3DVector(const int* perm, const int* permGradIndex, const float* px, const float* py, const float* pz, float* out)
+{
+	const V::FFloat one = V::Set(1.0f);
+	const V::FFloat two = V::Set(2.0f);
+	const V::FFloat zero = V::Set(0.0f);
+	const V::FFloat minusOne = V::Set(-1.0f);
+	const V::FFloat all = V::Equal(zero, zero);
+
+	const V::FFloat x = V::Load(px);
+	const V::FFloat y = V::Load(py);
+	const V::FFloat z = V::Load(pz);
+
+	// Place input coordinates on the simplectic lattice and floor to the rhombohedron super-cell origin
+	const V::FFloat stretchOffset = V::Mul(V::Add(V::Add(x, y), z), V::Set(Stretch3D));
+	const V::FFloat xs = V::Add(x, stretchOffset);
+	const V::FFloat ys = V::Add(y, stretchOffset);
+	const V::FFloat zs = V::Add(z, stretchOffset);
+
+	FNoiseCell3D cell;
+	cell.Perm = perm;
+	cell.PermGradIndex = permGradIndex;
+	cell.Xsb = V::FastFloor(xs);
+	cell.Ysb = V::FastFloor(ys);
+	cell.Zsb = V::FastFloor(zs);
+
+	const V::FFloat xsbd = V::ToFloat(cell.Xsb);
+	const V::FFloat ysbd = V::ToFloat(cell.Ysb);
+	const V::FFloat zsbd = V::ToFloat(cell.Zsb);
+
+	const V::FFloat squishOffset = V::Mul(V::Add(V::Add(xsbd, ysbd), zsbd), V::Set(Squish3D));
+	cell.Dx0 = V::Sub(x, V::Add(xsbd, squishOffset));
+	cell.Dy0 = V::Sub(y, V::Add(ysbd, squishOffset));
+	cell.Dz0 = V::Sub(z, V::Add(zsbd, squishOffset));
+
+	const V::FFloat xins = V::Sub(xs, xsbd);
+	const V::FFloat yins = V::Sub(ys, ysbd);
+	const V::FFloat zins = V::Sub(zs, zsbd);
+	const V::FFloat inSum = V::Add(V::Add(xins, yins), zins);
+
+	const V::FFloat inOctahedron = V::And(V::Greater(inSum, one), V::Less(inSum, two));
+	const V::FFloat inLower = V::LessEqual(inSum, one);
+	const V::FFloat inUpper = V::AndNot(V::AndNot(all, inOctahedron), inLower);
+
+	// Tetrahedron at (0,0,0): the closest two of its vertices pick the two extra vertices
+	FNoiseVector3 lowerExt0;
+	FNoiseVector3 lowerExt1;
+	{
+		const V::FFloat swapA = V::And(V::Less(xins, yins), V::Greater(zins, xins));
+		const V::FFloat swapB = V::AndNot(V::And(V::LessEqual(yins, xins), V::Greater(zins, yins)), swapA);
+		const V::FFloat aScore = V::Select(swapA, zins, xins);
+		const V::FFloat bScore = V::Select(swapB, zins, yins);
+		const FNoiseVector3 aPoint = Select3(swapA, Point3(4), Point3(1));
+		const FNoiseVector3 bPoint = Select3(swapB, Point3(4), Point3(2));
+
+		const V::FFloat wins = V::Sub(one, inSum);
+		const V::FFloat originClosest = V::Or(V::Greater(wins, aScore), V::Greater(wins, bScore));
+
+		// With (0,0,0) one of the two, the other is the closer of a and b
+		const FNoiseVector3 c = Select3(V::Greater(bScore, aScore), bPoint, aPoint);
+		const FNoiseVector3 originExt0 = { V::Select(c.X, one, minusOne), V::Select(c.Y, one, V::Select(c.X, minusOne, zero)), V::Select(c.Z, one, zero) };
+		const FNoiseVector3 originExt1 = { V::Select(c.X, one, zero), V::Select(c.Y, one, V::Select(c.X, zero, minusOne)), V::Select(c.Z, one, minusOne) };
+
+		const FNoiseVector3 ab = { V::Or(aPoint.X, bPoint.X), V::Or(aPoint.Y, bPoint.Y), V::Or(aPoint.Z, bPoint.Z) };
+		lowerExt0 = Select3(originClosest, originExt0, SelectPerAxis(ab, Offset3(1, 1, 1), Offset3(0, 0, 0)));
+		lowerExt1 = Select3(originClosest, originExt1, SelectPerAxis(ab, Offset3(1, 1, 1), Offset3(-1, -1, -1)));
+	}
+
+	// Tetrahedron at (1,1,1), mirrored
+	FNoiseVector3 upperExt0;
+	FNoiseVector3 upperExt1;
+	V::FFloat upperCornerClosest;
+	{
+		const V::FFloat swapB = V::And(V::LessEqual(xins, yins), V::Less(zins, yins));
+		const V::FFloat swapA = V::AndNot(V::And(V::Greater(xins, yins), V::Less(zins, xins)), swapB);
+		const V::FFloat aScore = V::Select(swapA, zins, xins);
+		const V::FFloat bScore = V::Select(swapB, zins, yins);
+		const FNoiseVector3 aPoint = Select3(swapA, Point3(3), Point3(6));
+		const FNoiseVector3 bPoint = Select3(swapB, Point3(3), Point3(5));
+
+		const V::FFloat wins = V::Sub(V::Set(3.0f), inSum);
+		upperCornerClosest = V::Or(V::Less(wins, aScore), V::Less(wins, bScore));
+
+		const FNoiseVector3 c = Select3(V::Less(bScore, aScore), bPoint, aPoint);
+		const FNoiseVector3 cornerExt0 = { V::Select(c.X, two, zero), V::Select(c.Y, V::Select(c.X, one, two), zero), V::Select(c.Z, one, zero) };
+		const FNoiseVector3 cornerExt1 = { V::Select(c.X, one, zero), V::Select(c.Y, V::Select(c.X, two, one), zero), V::Select(c.Z, two, zero) };
+
+		const FNoiseVector3 ab = { V::And(aPoint.X, bPoint.X), V::And(aPoint.Y, bPoint.Y), V::And(aPoint.Z, bPoint.Z) };
+		upperExt0 = Select3(upperCornerClosest, cornerExt0, SelectPerAxis(ab, Offset3(1, 1, 1), Offset3(0, 0, 0)));
+		upperExt1 = Select3(upperCornerClosest, cornerExt1, SelectPerAxis(ab, Offset3(2, 2, 2), Offset3(0, 0, 0)));
+	}
+
+	// Octahedron in between: the closest of each opposite pair, on the near or far side
+	FNoiseVector3 octahedronExt0;
+	FNoiseVector3 octahedronExt1;
+	{
+		const V::FFloat p1 = V::Add(xins, yins);
+		V::FFloat aFar = V::Greater(p1, one);
+		V::FFloat aScore = V::Select(aFar, V::Sub(p1, one), V::Sub(one, p1));
+		FNoiseVector3 aPoint = Select3(aFar, Point3(3), Point3(4));
+
+		const V::FFloat p2 = V::Add(xins, zins);
+		V::FFloat bFar = V::Greater(p2, one);
+		V::FFloat bScore = V::Select(bFar, V::Sub(p2, one), V::Sub(one, p2));
+		FNoiseVector3 bPoint = Select3(bFar, Point3(5), Point3(2));
+
+		const V::FFloat p3 = V::Add(yins, zins);
+		const V::FFloat cFar = V::Greater(p3, one);
+		const V::FFloat score = V::Select(cFar, V::Sub(p3, one), V::Sub(one, p3));
+		const FNoiseVector3 cPoint = Select3(cFar, Point3(6), Point3(1));
+
+		const V::FFloat replaceB = V::And(V::Greater(aScore, bScore), V::Less(bScore, score));
+		const V::FFloat replaceA = V::AndNot(V::And(V::LessEqual(aScore, bScore), V::Less(aScore, score)), replaceB);
+		bPoint = Select3(replaceB, cPoint, bPoint);
+		bFar = V::Select(replaceB, cFar, bFar);
+		aPoint = Select3(replaceA, cPoint, aPoint);
+		aFar = V::Select(replaceA, cFar, aFar);
+
+		const V::FFloat mixed = V::Xor(aFar, bFar);
+		const FNoiseVector3 both = { V::And(aPoint.X, bPoint.X), V::And(aPoint.Y, bPoint.Y), V::And(aPoint.Z, bPoint.Z) };
+		const FNoiseVector3 either = { V::Or(aPoint.X, bPoint.X), V::Or(aPoint.Y, bPoint.Y), V::Or(aPoint.Z, bPoint.Z) };
+
+		// With one point on each side, c1 is the far one and c2 the near one
+		const FNoiseVector3 farPoint = Select3(aFar, aPoint, bPoint);
+		const FNoiseVector3 nearPoint = Select3(aFar, bPoint, aPoint);
+
+		octahedronExt0 = Select3(mixed, AgainstFirstMissingAxis(farPoint), Select3(aFar, Offset3(1, 1, 1), Offset3(0, 0, 0)));
+		octahedronExt1 = Select3(mixed, AlongFirstAxis(nearPoint), Select3(aFar, AlongFirstAxis(both), AgainstFirstMissingAxis(either)));
+	}
+
+	const FNoiseVector3 ext0 = Select3(inOctahedron, octahedronExt0, Select3(inLower, lowerExt0, upperExt0));
+	const FNoiseVector3 ext1 = Select3(inOctahedron, octahedronExt1, Select3(inLower, lowerExt1, upperExt1));
+
+	// Near (1,1,1) the scalar reaches y + 2 by stepping y + 1 down once more, which rounds differently
+	const V::FFloat steppedY = V::And(inUpper, upperCornerClosest);
+	const V::FFloat steppedDy = V::Sub(V::Sub(V::Sub(cell.Dy0, one), V::Set(Squish3D * 3.0f)), one);
+
+	FNoiseVertex3D ext0Vertex = cell.Vertex(ext0);
+	FNoiseVertex3D ext1Vertex = cell.Vertex(ext1);
+	ext0Vertex.Dy = V::Select(V::And(steppedY, V::Equal(ext0.Y, two)), steppedDy, ext0Vertex.Dy);
+	ext1Vertex.Dy = V::Select(V::And(steppedY, V::Equal(ext1.Y, two)), steppedDy, ext1Vertex.Dy);
+
+	// The scalar's nine slots: the cell's own vertices, zero where the cell has fewer, then the two extra vertices
+	const FNoiseVertex3D vertices[9] =
+	{
+		cell.Vertex(Select3(inLower, Offset3(0, 0, 0), Offset3(1, 1, 1))),
+		cell.Vertex(Select3(inUpper, Offset3(0, 1, 1), Offset3(1, 0, 0))),
+		cell.Vertex(Select3(inUpper, Offset3(1, 0, 1), Offset3(0, 1, 0))),
+		cell.Vertex(Select3(inUpper, Offset3(1, 1, 0), Offset3(0, 0, 1))),
+		cell.Vertex(Offset3(1, 1, 0)),
+		cell.Vertex(Offset3(1, 0, 1)),
+		cell.Vertex(Offset3(0, 1, 1)),
+		ext0Vertex,
+		ext1Vertex
+	};
+
+	V::FFloat contributions[9];
+	cell.Contributions(vertices, contributions);
+
+	contributions[0] = V::Select(inOctahedron, zero, contributions[0]);
+	for (int slot = 4; slot < 7; slot++)
+	{
+		contributions[slot] = V::Select(inOctahedron, contributions[slot], zero);
+	}
+
+	V::FFloat value = zero;
+	for (const V::FFloat& contribution : contributions)
+	{
+		value = V::Add(value, contribution);
+	}
+
+	V::Store(out, V::Mul(value, V::Set(Norm3D)));
+}
+
+#endif
+
+Noise2D::Noise2D(int64_t InSeed)
+	: Impl(std::make_unique<FImpl>(InSeed))
+{
+}
+
+Noise2D::~Noise2D()
+{
+}
+
+float Noise2D::Eval(float x, float y) const
+{
+	return Impl->eval(x, y);
+}
+
+void Noise2D::EvalBatch(const float* x, const float* y, float* out, int count) const
+{
+	int i = 0;
+
+#if defined(NOISE_SIMD_AVX2) || defined(NOISE_SIMD_SSE2)
+	const int* perm = Impl->GetPerm();
+	for (; i + V::Width <= count; i += V::Width)
+	{
+		EvalNoise2DVector(perm, x + i, y + i, out + i);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		out[i] = Impl->eval(x[i], y[i]);
+	}
+}
+
+Noise3D::Noise3D(int64_t InSeed)
+	: Impl(std::make_unique<FImpl>(InSeed))
+{
+}
+
+Noise3D::~Noise3D()
+{
+}
+
+float Noise3D::Eval(float x, float y, float z) const
+{
+	return Impl->eval(x, y, z);
+}
+
+void Noise3D::EvalBatch(const float* x, const float* y, const float* z, float* out, int count) const
+{
+	int i = 0;
+
+#if defined(NOISE_SIMD_AVX2) || defined(NOISE_SIMD_SSE2)
+	for (; i + V::Width <= count; i += V::Width)
+	{
+		EvalNoise3DVector(Impl->GetPerm(), Impl->PermGradIndex, x + i, y + i, z + i, out + i);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		out[i] = Impl->eval(x[i], y[i], z[i]);
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+/**
+ * Seeded OpenSimplex noise with scalar and batched evaluation.
+ *
+ * OpenSimplexNoise.hh defines its gradient tables in the header, so it is only included by Noise.cpp;
+ * everything else goes through these wrappers.
+ *
+ * Batched results are bit-for-bit identical to Eval as long as the compiler does not contract multiply-adds
+ * into FMA (the default for MSVC's /fp:precise). Builds that allow contraction agree to within 1e-6.
+ */
+class Noise2D
+{
+public:
+
+	Noise2D(int64_t InSeed);
+	~Noise2D();
+
+	float Eval(float x, float y) const;
+
+	/** Evaluates count points given as separate coordinate arrays. Uses AVX2 or SSE2 where available. */
+	void EvalBatch(const float* x, const float* y, float* out, int count) const;
+
+private:
+
+	struct FImpl;
+	std::unique_ptr<const FImpl> Impl;
+};
+
+class Noise3D
+{
+public:
+
+	Noise3D(int64_t InSeed);
+	~Noise3D();
+
+	float Eval(float x, float y, float z) const;
+
+	/**
+	 * Evaluates count points given as separate coordinate arrays. Uses AVX2 or SSE2 where available; the lattice
+	 * walk's branches become masks, so every lane pays for all nine candidate vertices.
+	 */
+	void EvalBatch(const float* x, const float* y, const float* z, float* out, int count) const;
+
+private:
+
+	struct FImpl;
+	std::unique_ptr<const FImpl> Impl;
+};
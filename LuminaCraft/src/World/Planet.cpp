@@ -57,7 +57,7 @@ void Planet::Update(double DeltaTime)
 
 		// Current chunk
 		chunkQueue = {};
-		if (!chunks.contains({ camChunkX, camChunkY, camChunkZ }))
+		if (!chunks.Contains(ChunkCoord(camChunkX, camChunkY, camChunkZ)))
 		{
 			chunkQueue.emplace(camChunkX, camChunkY, camChunkZ);
 		}
@@ -136,42 +136,44 @@ void Planet::Update(double DeltaTime)
 	else if (chunksLoading == 0 && !chunkQueue.empty())
 	{
 		// Queue is not empty. Process front item in queue
-		glm::vec3 next = chunkQueue.front();
+		const ChunkCoord next = chunkQueue.front();
 		chunkQueue.pop();
 
-		std::tuple<int, int, int> chunkTuple{ next.x, next.y, next.z };
-
-		if (!chunks.contains(chunkTuple))
+		if (!chunks.Contains(next))
 		{
-			chunks.try_emplace(chunkTuple, chunkSize, next);
+			chunks.TryEmplace(next, std::make_shared<Chunk>(chunkSize, next.ToIVec3(), nullptr));
 		}
 	}
 
 	chunksLoading = 0;
 	numChunks = 0;
 	numChunksRendered = 0;
-	for (auto it = chunks.begin(); it != chunks.end(); )
+	for (auto& [coord, chunk] : chunks)
 	{
 		numChunks++;
 
-		if (!it->second.ready)
+		if (!chunk->ready)
 			chunksLoading++;
 
-		int chunkX = it->second.chunkPos.x;
-		int chunkY = it->second.chunkPos.y;
-		int chunkZ = it->second.chunkPos.z;
-		if (it->second.ready && (abs(chunkX - camChunkX) > renderDistance ||
+		int chunkX = chunk->chunkPos.x;
+		int chunkY = chunk->chunkPos.y;
+		int chunkZ = chunk->chunkPos.z;
+		if (chunk->ready && (abs(chunkX - camChunkX) > renderDistance ||
 			abs(chunkY - camChunkY) > renderDistance ||
 			abs(chunkZ - camChunkZ) > renderDistance))
 		{
-			it->second.~Chunk();
-			it = chunks.erase(it);
+			chunksToUnload.push_back(coord);
 		}
 		else
 		{
 			numChunksRendered++;
-			it->second.Render(modelLoc);
-			++it;
+			chunk->Render(modelLoc);
 		}
 	}
+
+	for (const ChunkCoord& coord : chunksToUnload)
+	{
+		chunks.Erase(coord);
+	}
+	chunksToUnload.clear();
 }
\ No newline at end of file
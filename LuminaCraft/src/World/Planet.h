@@ -1,12 +1,12 @@
 #pragma once
 
-#include <unordered_map>
 #include <string>
 #include <queue>
 #include <glm/glm.hpp>
 
 #include "Chunk.h"
-#include "../TupleHash.h"
+#include "ChunkCoord.h"
+#include "../FlatHashMap.h"
 #include "Camera.h"
 
 class Planet
@@ -33,8 +33,9 @@ private:
 
 	std::shared_ptr<Camera> MainCamera;
 
-	std::unordered_map<std::tuple<int, int, int>, Chunk> chunks;
-	std::queue<glm::vec3> chunkQueue;
+	TFlatHashMap<ChunkCoord, std::shared_ptr<Chunk>> chunks;
+	std::queue<ChunkCoord> chunkQueue;
+	std::vector<ChunkCoord> chunksToUnload;
 	int renderDistance = 10;
 	int renderHeight = 1;
 	unsigned int chunkSize = 32;
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "../FlatHashMap.h"
+
+/**
+ * Thread-safe, bounded LRU cache of immutable values shared between worker threads.
+ * Concurrent requests for a key that is still being computed wait on that single computation.
+ */
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>>
+class TSharedCache
+{
+public:
+
+	using FValuePtr = std::shared_ptr<const TValue>;
+	using FSizeFunction = std::function<size_t(const TValue&)>;
+
+	TSharedCache(size_t InMaxEntries, FSizeFunction InSizeOf)
+		: MaxEntries(InMaxEntries), SizeOf(std::move(InSizeOf))
+	{
+	}
+
+	/** Returns the cached value, calling Create() on this thread if no other thread is already computing it */
+	template <typename TCreateFunction>
+	FValuePtr GetOrCreate(const TKey& Key, TCreateFunction&& Create)
+	{
+		std::promise<FValuePtr> Promise;
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+
+			if (FEntry* Existing = Entries.Find(Key))
+			{
+				Hits.fetch_add(1, std::memory_order_relaxed);
+				LRU.splice(LRU.begin(), LRU, Existing->LRUIt);
+
+				// Copy the future so an in-flight computation can be waited on without holding the lock
+				std::shared_future<FValuePtr> Future = Existing->Future;
+				Lock.unlock();
+
+				return Future.get();
+			}
+
+			Misses.fetch_add(1, std::memory_order_relaxed);
+			LRU.push_front(Key);
+
+			FEntry& Entry = Entries[Key];
+			Entry.Future = Promise.get_future().share();
+			Entry.LRUIt = LRU.begin();
+		}
+
+		FValuePtr Value;
+		try
+		{
+			Value = Create();
+		}
+		catch (...)
+		{
+			// Waiters get the same exception, and the key is dropped so the next request tries again
+			Promise.set_exception(std::current_exception());
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+
+				FEntry* Entry = Entries.Find(Key);
+				if (Entry && !Entry->bReady)
+				{
+					LRU.erase(Entry->LRUIt);
+					Entries.Erase(Key);
+				}
+			}
+			throw;
+		}
+		Promise.set_value(Value);
+
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+
+			FEntry* Entry = Entries.Find(Key);
+			if (Entry && !Entry->bReady)
+			{
+				Entry->bReady = true;
+				Entry->Bytes = SizeOf(*Value);
+				ReadyBytes += Entry->Bytes;
+			}
+
+			EvictLocked();
+		}
+
+		return Value;
+	}
+
+	/** Returns the cached value if it is ready, without computing or waiting */
+	FValuePtr Find(const TKey& Key)
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+
+		FEntry* Entry = Entries.Find(Key);
+		if (!Entry || !Entry->bReady)
+		{
+			Misses.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Hits.fetch_add(1, std::memory_order_relaxed);
+		LRU.splice(LRU.begin(), LRU, Entry->LRUIt);
+
+		return Entry->Future.get();
+	}
+
+	/** Moves a key to the cold end of the LRU so it is the next to be evicted */
+	void Demote(const TKey& Key)
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+
+		if (FEntry* Entry = Entries.Find(Key))
+		{
+			LRU.splice(LRU.end(), LRU, Entry->LRUIt);
+		}
+	}
+
+	void Clear()
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+
+		// In-flight entries are left alone so their waiters still resolve
+		Entries.EraseIf([this](std::pair<TKey, FEntry>& Entry)
+		{
+			if (!Entry.second.bReady)
+			{
+				return false;
+			}
+
+			ReadyBytes -= Entry.second.Bytes;
+			LRU.erase(Entry.second.LRUIt);
+			return true;
+		});
+	}
+
+	uint64_t GetHits() const { return Hits.load(std::memory_order_relaxed); }
+	uint64_t GetMisses() const { return Misses.load(std::memory_order_relaxed); }
+
+	float GetHitRate() const
+	{
+		const uint64_t hits = GetHits();
+		const uint64_t total = hits + GetMisses();
+
+		return total > 0 ? static_cast<float>(hits) / static_cast<float>(total) : 0.0f;
+	}
+
+	size_t GetNumEntries() const
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return Entries.Size();
+	}
+
+	size_t GetBytes() const
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return ReadyBytes;
+	}
+
+private:
+
+	struct FEntry
+	{
+		std::shared_future<FValuePtr> Future;
+		typename std::list<TKey>::iterator LRUIt;
+		size_t Bytes = 0;
+		bool bReady = false;
+	};
+
+	/** Drops least recently used entries until the cache fits its bound. Caller must hold Mutex. */
+	void EvictLocked()
+	{
+		// Walk from the cold end, skipping anything still being computed
+		auto it = LRU.end();
+		while (Entries.Size() > MaxEntries && it != LRU.begin())
+		{
+			--it;
+
+			const FEntry* Entry = Entries.Find(*it);
+			if (!Entry->bReady)
+			{
+				continue;
+			}
+
+			ReadyBytes -= Entry->Bytes;
+			Entries.Erase(*it);
+			it = LRU.erase(it);
+		}
+	}
+
+private:
+
+	size_t MaxEntries;
+	FSizeFunction SizeOf;
+
+	mutable std::mutex Mutex;
+	TFlatHashMap<TKey, FEntry, THash> Entries;
+
+	/** Most recently used at the front */
+	std::list<TKey> LRU;
+
+	size_t ReadyBytes = 0;
+
+	std::atomic<uint64_t> Hits = 0;
+	std::atomic<uint64_t> Misses = 0;
+};
@@ -0,0 +1,92 @@
+#include "VoxelCache.h"
+
+#include <algorithm>
+
+#include "ColumnCache.h"
+#include "WorldGenerator.h"
+
+VoxelCache::VoxelCache(std::shared_ptr<const WorldGenerator> InGenerator, std::shared_ptr<ColumnCache> InColumnCache, int InChunkSize, size_t InMaxEntries)
+	: Generator(std::move(InGenerator)), Columns(std::move(InColumnCache)), ChunkSize(InChunkSize),
+	  Cache(InMaxEntries, [this](const BlockStorage& Volume)
+	  {
+		  // Shared uniform volumes are owned here, not by the entry
+		  return IsSharedVolume(Volume) ? 0 : Volume.GetMemoryUsage();
+	  })
+{
+	const size_t volumeSize = static_cast<size_t>(ChunkSize) * ChunkSize * ChunkSize;
+
+	for (size_t block = 0; block < UniformVolumes.size(); block++)
+	{
+		UniformVolumes[block] = std::make_shared<const BlockStorage>(volumeSize, static_cast<BlockID>(block));
+	}
+}
+
+VoxelCache::~VoxelCache()
+{
+}
+
+VoxelData VoxelCache::GetOrGenerate(const glm::ivec3& chunkPos)
+{
+	return Cache.GetOrCreate(ChunkCoord(chunkPos), [this, chunkPos]
+	{
+		const std::shared_ptr<const FColumnData> Column = Columns->GetOrGenerate(chunkPos.x, chunkPos.z);
+
+		BlockID block;
+		if (Generator->FindUniformBlock(chunkPos.x, chunkPos.y, chunkPos.z, ChunkSize, *Column, &block))
+		{
+			UniformProven.fetch_add(1, std::memory_order_relaxed);
+			return UniformVolumes[block];
+		}
+
+		// Raw ids only live long enough to be compressed
+		thread_local std::vector<BlockID> blocks;
+		Generator->GenerateChunkData(chunkPos.x, chunkPos.y, chunkPos.z, ChunkSize, *Column, &blocks);
+
+		return Compress(blocks);
+	});
+}
+
+bool VoxelCache::GetUniformBlock(const VoxelData& volume, BlockID* block) const
+{
+	if (!volume || !volume->IsUniform())
+	{
+		return false;
+	}
+
+	*block = volume->Get(0);
+	return true;
+}
+
+VoxelData VoxelCache::Compress(const std::vector<BlockID>& blocks)
+{
+	auto volume = std::make_shared<const BlockStorage>(blocks);
+	if (!volume->IsUniform())
+	{
+		return volume;
+	}
+
+	UniformScanned.fetch_add(1, std::memory_order_relaxed);
+
+	const BlockID block = volume->Get(0);
+	return block < UniformVolumes.size() ? UniformVolumes[block] : volume;
+}
+
+bool VoxelCache::IsSharedVolume(const BlockStorage& volume) const
+{
+	return std::any_of(UniformVolumes.begin(), UniformVolumes.end(), [&volume](const VoxelData& shared) { return shared.get() == &volume; });
+}
+
+VoxelData VoxelCache::Find(const glm::ivec3& chunkPos)
+{
+	return Cache.Find(ChunkCoord(chunkPos));
+}
+
+void VoxelCache::Release(const glm::ivec3& chunkPos)
+{
+	Cache.Demote(ChunkCoord(chunkPos));
+}
+
+void VoxelCache::Clear()
+{
+	Cache.Clear();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BlockStorage.h"
+#include "SharedCache.h"
+#include "ChunkCoord.h"
+
+class WorldGenerator;
+class ColumnCache;
+
+/** Immutable generated block volume, shared by the owning chunk and every neighbour meshing against it */
+using VoxelData = std::shared_ptr<const BlockStorage>;
+
+/**
+ * Thread-safe, bounded cache of generated chunk volumes keyed by chunk coordinate.
+ * Generation jobs that ask for the same coordinate concurrently wait on a single computation.
+ *
+ * Chunks made of a single block type (open sky, solid rock) all share one immutable volume per block type
+ * instead of allocating their own; those entries count as 0 bytes.
+ */
+class VoxelCache
+{
+public:
+
+	VoxelCache(std::shared_ptr<const WorldGenerator> InGenerator, std::shared_ptr<ColumnCache> InColumnCache, int InChunkSize, size_t InMaxEntries);
+	~VoxelCache();
+
+	/** Returns the generated volume for a chunk, generating it on the calling thread if no other job has */
+	VoxelData GetOrGenerate(const glm::ivec3& chunkPos);
+
+	/** Returns the generated volume for a chunk if it is already cached, without generating or waiting */
+	VoxelData Find(const glm::ivec3& chunkPos);
+
+	/** Returns true if every voxel of the volume is the same block, and which block that is */
+	bool GetUniformBlock(const VoxelData& volume, BlockID* block) const;
+
+	/** Called when the chunk unloads so its volume is the first to be evicted */
+	void Release(const glm::ivec3& chunkPos);
+
+	void Clear();
+
+	uint64_t GetHits() const { return Cache.GetHits(); }
+	uint64_t GetMisses() const { return Cache.GetMisses(); }
+	float GetHitRate() const { return Cache.GetHitRate(); }
+	size_t GetNumEntries() const { return Cache.GetNumEntries(); }
+	size_t GetBytes() const { return Cache.GetBytes(); }
+
+	/** Uniform chunks proven from the column and cave bounds without generating them */
+	uint64_t GetNumUniformProven() const { return UniformProven.load(std::memory_order_relaxed); }
+
+	/** Uniform chunks only detected by scanning the generated volume */
+	uint64_t GetNumUniformScanned() const { return UniformScanned.load(std::memory_order_relaxed); }
+
+private:
+
+	/** Compresses a freshly generated volume, or returns the shared uniform volume if every voxel is the same */
+	VoxelData Compress(const std::vector<BlockID>& blocks);
+
+	/** Whether volume is one of UniformVolumes, which cache entries share rather than own */
+	bool IsSharedVolume(const BlockStorage& volume) const;
+
+private:
+
+	std::shared_ptr<const WorldGenerator> Generator;
+	std::shared_ptr<ColumnCache> Columns;
+	int ChunkSize;
+
+	/** One uniform volume per generated block type, indexed by Block::EBlockType */
+	std::array<VoxelData, 4> UniformVolumes;
+
+	TSharedCache<ChunkCoord, BlockStorage> Cache;
+
+	std::atomic<uint64_t> UniformProven = 0;
+	std::atomic<uint64_t> UniformScanned = 0;
+};
@@ -1,4 +1,6 @@
 #include "World.h"
+#include <algorithm>
+#include <cassert>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -8,12 +10,75 @@
 #include "../Application.h"
 #include "../Player/Player.h"
 #include "../Debug/DebugLine.h"
-
-World::World(std::string InWorldName)
+#include "../Renderer/FaceInstance.h"
+#include "../Renderer/MeshUploader.h"
+#include "ChunkBuildJob.h"
+#include "ChunkScheduler.h"
+#include "ChunkVolume.h"
+#include "ColumnCache.h"
+#include "WorldGenerator.h"
+
+World::World(std::string InWorldName, int64_t InSeed)
 	:WorldName(std::move(InWorldName))
 {
 	m_Player = std::make_shared<Player>(this);
 
+    // Face instances store each face's cell within its chunk in 6 bits per axis
+    assert(chunkSize <= FFaceInstance::MaxChunkSize && "chunkSize does not fit FFaceInstance's packed positions");
+
+#ifdef _DEBUG
+    if (!WorldGenerator::VerifyDeterminism())
+    {
+        LOG_ERROR("World generation no longer matches the golden region hash; update WorldGenerator::GoldenRegionHash if this was intended");
+    }
+    if (!OcclusionBuffer::SelfTest(Application::GetThreadPool().get()))
+    {
+        LOG_ERROR("Occlusion buffer self test failed");
+    }
+    if (!ChunkBuildJob::VerifyMeshers())
+    {
+        LOG_ERROR("Bitmask meshers no longer build the same faces as the naive and greedy meshers");
+    }
+#endif
+
+    worldGenerator = std::make_shared<WorldGenerator>(InSeed);
+
+    // Enough room for every chunk in view plus the one-chunk ring of neighbours meshing reads from
+    const size_t cacheWidth = 2 * (renderDistance + 1) + 1;
+    const size_t cacheHeight = 2 * (renderHeight + 1) + 1;
+    columnCache = std::make_shared<ColumnCache>(worldGenerator, chunkSize, cacheWidth * cacheWidth * 2);
+    voxelCache = std::make_shared<VoxelCache>(worldGenerator, columnCache, chunkSize, cacheWidth * cacheWidth * cacheHeight);
+
+    // Half the height of the load sphere at each column offset, or -1 outside the load circle
+    loadColumnHalfHeights.resize((2 * renderDistance + 1) * (2 * renderDistance + 1));
+    for (int dx = -renderDistance; dx <= renderDistance; dx++)
+    {
+        for (int dz = -renderDistance; dz <= renderDistance; dz++)
+        {
+            const int remaining = renderDistance * renderDistance - dx * dx - dz * dz;
+
+            int halfHeight = -1;
+            while ((halfHeight + 1) * (halfHeight + 1) <= remaining)
+            {
+                halfHeight++;
+            }
+
+            loadColumnHalfHeights[(dx + renderDistance) * (2 * renderDistance + 1) + dz + renderDistance] = halfHeight;
+        }
+    }
+
+    // Streaming only ever loads y in [-renderHeight, renderHeight], so the grid's vertical centre stays at 0
+    chunks.Reset(glm::ivec3(renderDistance, renderHeight, renderDistance));
+    chunkVisibility.Reset(glm::ivec3(renderDistance, renderHeight, renderDistance));
+
+    // One job per worker keeps the pool busy without queueing chunks that may be out of range before they start
+    chunkScheduler = std::make_shared<ChunkScheduler>(Application::GetThreadPool()->get_thread_count());
+    chunkJobStats = std::make_shared<FChunkJobStats>();
+    completedChunkJobs = std::make_shared<ChunkJobQueue>();
+
+    // A few chunk meshes per frame at 60 fps; overflow waits for the next frame
+    meshUploader = std::make_shared<MeshUploader>(4 * 1024 * 1024, 2.0);
+
     std::shared_ptr<Shader> DebugShader = std::make_shared<Shader>("assets/shaders/debug_shader.glsl", "assets/shaders/debug_shader.glsl");
     ShaderLibrary::PushShader("DebugShader", DebugShader);
     
@@ -33,14 +98,14 @@ World::World(std::string InWorldName)
 
 World::~World()
 {
-    chunkQueue.empty();
-    chunks.empty();
+    // Dropping the chunks cancels their build jobs; running ones hold their own references to the caches
+    chunks.Reset(glm::ivec3(0));
 }
 
-std::shared_ptr<World> World::CreateWorld(const std::string& InWorldName)
+std::shared_ptr<World> World::CreateWorld(const std::string& InWorldName, int64_t InSeed)
 {
-	LOG_INFO("Creating World: {0}", InWorldName);
-	return std::make_shared<World>(InWorldName);
+	LOG_INFO("Creating World: {0} (seed {1})", InWorldName, InSeed);
+	return std::make_shared<World>(InWorldName, InSeed);
 }
 
 
@@ -80,81 +145,291 @@ void World::Update(double DeltaTime)
 
     if (camChunkX != lastCamX || camChunkY != lastCamY || camChunkZ != lastCamZ)
     {
+        const glm::ivec3 lastCamChunk(lastCamX, lastCamY, lastCamZ);
         lastCamX = camChunkX;
         lastCamY = camChunkY;
         lastCamZ = camChunkZ;
 
-        chunkQueue = {};
-        if (!chunks.contains({ camChunkX, camChunkY, camChunkZ }))
+        // Moving one chunk recycles one slab of the grid. Chunks still building are cancelled as they are dropped.
+        chunks.Recenter(glm::ivec3(camChunkX, 0, camChunkZ), [this](const ChunkCoord&, std::shared_ptr<Chunk>& chunk)
         {
-            chunkQueue.emplace(camChunkX, camChunkY, camChunkZ);
-        }
+            ReleaseChunkCaches(chunk->chunkPos);
+        });
 
-        // Circular chunk generation
-        for (int r = 0; r <= renderDistance; r++)
-        {
-            for (int x = -r; x <= r; x++)
-            {
-                for (int z = -r; z <= r; z++)
-                {
-                    if (x * x + z * z <= r * r)
-                    {
-                        for (int y = 0; y <= renderHeight; y++)
-                        {
-                            chunkQueue.emplace(camChunkX + x, y, camChunkZ + z);
-                            chunkQueue.emplace(camChunkX + x, -y, camChunkZ + z);
-                        }
-                    }
-                }
-            }
-        }
+        UpdateLoadSet(lastCamChunk, glm::ivec3(camChunkX, camChunkY, camChunkZ));
     }
-    else if (chunksLoading == 0 && !chunkQueue.empty())
+
+    chunkScheduler->UpdateView(glm::ivec3(camChunkX, camChunkY, camChunkZ), Camera->GetCameraForwardVector());
+    chunkScheduler->Dispatch(chunkJobStats->InFlight.load(std::memory_order_relaxed), [this](const ChunkCoord& coord)
     {
-        glm::vec3 next = chunkQueue.front();
-        chunkQueue.pop();
+        const glm::ivec3 chunkPos = coord.ToIVec3();
+        if (!chunks.Contains(chunkPos) || chunks.Find(chunkPos))
+        {
+            return false;
+        }
 
-        const std::tuple<int, int, int> chunkTuple{ next.x, next.y, next.z };
+        chunks.Insert(chunkPos, std::make_shared<Chunk>(chunkSize, chunkPos, this));
+        numLoadedChunksPerColumn[ChunkCoord(chunkPos.x, 0, chunkPos.z)]++;
+        return true;
+    });
 
-        if (!chunks.contains(chunkTuple))
+    // Only chunks whose job actually finished are touched. A job whose chunk was dropped or replaced is ignored.
+    uint32_t numCompleted = 0;
+    completedChunkJobs->Drain([&](std::shared_ptr<ChunkBuildJob> job)
+    {
+        std::shared_ptr<Chunk>* chunk = chunks.Find(job->GetChunkPos());
+        if (chunk && (*chunk)->FinishBuild(job, *meshUploader))
         {
-            chunks.try_emplace(chunkTuple, std::make_shared<Chunk>(chunkSize, next));
+            numCompleted++;
         }
-    }
+    });
+    meshUploader->Process();
+
+    Frustum frustum;
+    frustum.extractPlanes(Camera->GetViewProjectionMatrix());
+
+    // Chunks that have not been built yet are treated as open so nothing behind them is hidden
+    const bool bCaveCulled = bCaveCulling && chunkVisibility.Search(frustum, glm::ivec3(camChunkX, camChunkY, camChunkZ), chunks.GetCenter(), chunkSize,
+        [this](const glm::ivec3& chunkPos)
+        {
+            const std::shared_ptr<Chunk>* chunk = chunks.Find(chunkPos);
+            return chunk && (*chunk)->ready ? (*chunk)->GetConnectivity() : FChunkConnectivity::All();
+        });
 
-    chunksLoading = 0;
     numChunks = 0;
-    numChunksRendered = 0;
-    for (auto it = chunks.begin(); it != chunks.end();)
+    numChunksOccluded = 0;
+    drawCandidates.clear();
+    drawCandidatePositions.clear();
+    chunks.ForEach([&](const ChunkCoord& coord, std::shared_ptr<Chunk>& chunk)
     {
         numChunks++;
-        if (!it->second->ready)
+        if ((glm::distance(glm::vec3(chunk->chunkPos.x, chunk->chunkPos.y, chunk->chunkPos.z), glm::vec3(camChunkX, camChunkY, camChunkZ)) > renderDistance))
+        {
+            // Chunks still building are cancelled rather than left to finish work nobody will see.
+            // Cached generation data for unloaded chunks goes first when the caches fill up.
+            ReleaseChunkCaches(chunk->chunkPos);
+            chunksToUnload.push_back(coord);
+        }
+        else if (!chunk->ready)
         {
-            chunksLoading++;
+            // Still building, so there is nothing to draw yet
         }
-        if (it->second->ready && (glm::distance(glm::vec3(it->second->chunkPos.x, it->second->chunkPos.y, it->second->chunkPos.z), glm::vec3(camChunkX, camChunkY, camChunkZ)) > renderDistance))
+        else if (bCaveCulled && !chunkVisibility.IsReachable(chunk->chunkPos))
         {
-            it = chunks.erase(it);
+            numChunksOccluded++;
         }
         else
         {
-            numChunksRendered++;
-            it->second->Render(modelLoc);
-            ++it;
+            drawCandidates.push_back(chunk.get());
+            drawCandidatePositions.push_back(chunk->chunkPos);
         }
+    });
 
+    visibleChunks.clear();
+    chunkCuller.Cull(frustum, drawCandidatePositions, chunkSize, &visibleChunks);
+    numChunksCulled = static_cast<uint32_t>(drawCandidates.size() - visibleChunks.size());
+
+    // The solid parts of the chunks in view hide chunks further back
+    if (bOcclusionCulling)
+    {
+        occluderBoxes.clear();
+        for (const uint32_t index : visibleChunks)
+        {
+            const glm::ivec3 offset = drawCandidatePositions[index] - glm::ivec3(camChunkX, camChunkY, camChunkZ);
+            if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z > occluderDistance * occluderDistance)
+            {
+                continue;
+            }
+
+            drawCandidates[index]->GetOccluders().AppendBoxes(glm::vec3(drawCandidatePositions[index] * static_cast<int>(chunkSize)), chunkSize, &occluderBoxes);
+        }
+        occlusionBuffer.Rasterize(Camera->GetViewProjectionMatrix(), occluderBoxes, Application::GetThreadPool().get());
     }
+
+    numChunksRendered = 0;
+    numChunksDepthCulled = 0;
+    for (const uint32_t index : visibleChunks)
+    {
+        const glm::vec3 chunkMin = glm::vec3(drawCandidatePositions[index] * static_cast<int>(chunkSize));
+        if (bOcclusionCulling && !occlusionBuffer.IsVisible(chunkMin, chunkMin + static_cast<float>(chunkSize)))
+        {
+            numChunksDepthCulled++;
+            continue;
+        }
+
+        drawCandidates[index]->Render(modelLoc);
+        numChunksRendered++;
+    }
+
+    for (const ChunkCoord& coord : chunksToUnload)
+    {
+        chunks.Erase(coord.ToIVec3());
+    }
+    chunksToUnload.clear();
+
+    chunkScheduler->Tick(DeltaTime, numCompleted);
     
     UpdateDebugLines(DeltaTime);
     RenderDebugLines();
     
 }
 
+void World::SetMeshingMode(EMeshingMode InMeshingMode)
+{
+    if (InMeshingMode == meshingMode)
+    {
+        return;
+    }
+    meshingMode = InMeshingMode;
+
+    // Dropping every chunk and forgetting the camera chunk makes the next Update queue the whole load set again
+    chunks.ForEach([this](const ChunkCoord&, std::shared_ptr<Chunk>& chunk)
+    {
+        ReleaseChunkCaches(chunk->chunkPos);
+    });
+    chunks.Reset(chunks.GetRadius(), chunks.GetCenter());
+    chunkScheduler->Clear();
+
+    bHasLoadSet = false;
+    lastCamX = lastCamY = lastCamZ = -100;
+}
+
+void World::ReleaseChunkCaches(const glm::ivec3& chunkPos)
+{
+    voxelCache->Release(chunkPos);
+
+    // Releasing demotes the column to the next eviction, so chunks still loaded above or below must keep it warm
+    const ChunkCoord column(chunkPos.x, 0, chunkPos.z);
+    uint32_t* numLoaded = numLoadedChunksPerColumn.Find(column);
+    if (numLoaded && --*numLoaded == 0)
+    {
+        numLoadedChunksPerColumn.Erase(column);
+        columnCache->Release(chunkPos.x, chunkPos.z);
+    }
+}
+
+void World::UpdateLoadSet(const glm::ivec3& oldCamChunk, const glm::ivec3& newCamChunk)
+{
+    // Only the part of each column's range that the other camera position didn't cover changes, so a one-chunk move
+    // touches just the shell of chunks entering and leaving rather than the whole load set
+    for (int x = newCamChunk.x - renderDistance; x <= newCamChunk.x + renderDistance; x++)
+    {
+        for (int z = newCamChunk.z - renderDistance; z <= newCamChunk.z + renderDistance; z++)
+        {
+            int minY, maxY, oldMinY, oldMaxY;
+            if (!GetLoadColumnRange(x, z, newCamChunk, &minY, &maxY))
+            {
+                continue;
+            }
+
+            const bool bWasLoading = bHasLoadSet && GetLoadColumnRange(x, z, oldCamChunk, &oldMinY, &oldMaxY);
+            for (int y = minY; y <= maxY; y++)
+            {
+                if (bWasLoading && y >= oldMinY && y <= oldMaxY)
+                {
+                    y = oldMaxY;
+                    continue;
+                }
+
+                if (!chunks.Find(glm::ivec3(x, y, z)))
+                {
+                    chunkScheduler->Add(ChunkCoord(x, y, z));
+                }
+            }
+        }
+    }
+
+    if (bHasLoadSet)
+    {
+        for (int x = oldCamChunk.x - renderDistance; x <= oldCamChunk.x + renderDistance; x++)
+        {
+            for (int z = oldCamChunk.z - renderDistance; z <= oldCamChunk.z + renderDistance; z++)
+            {
+                int minY, maxY, newMinY, newMaxY;
+                if (!GetLoadColumnRange(x, z, oldCamChunk, &minY, &maxY))
+                {
+                    continue;
+                }
+
+                const bool bStillLoading = GetLoadColumnRange(x, z, newCamChunk, &newMinY, &newMaxY);
+                for (int y = minY; y <= maxY; y++)
+                {
+                    if (bStillLoading && y >= newMinY && y <= newMaxY)
+                    {
+                        y = newMaxY;
+                        continue;
+                    }
+
+                    chunkScheduler->Remove(ChunkCoord(x, y, z));
+                }
+            }
+        }
+    }
+
+    bHasLoadSet = true;
+}
+
+bool World::GetLoadColumnRange(int x, int z, const glm::ivec3& camChunk, int* minY, int* maxY) const
+{
+    // Same rule the unload check applies: within renderDistance of the camera chunk and within renderHeight of y = 0
+    const int dx = x - camChunk.x;
+    const int dz = z - camChunk.z;
+    if (std::abs(dx) > renderDistance || std::abs(dz) > renderDistance)
+    {
+        return false;
+    }
+
+    const int halfHeight = loadColumnHalfHeights[(dx + renderDistance) * (2 * renderDistance + 1) + dz + renderDistance];
+    if (halfHeight < 0)
+    {
+        return false;
+    }
+
+    *minY = std::max(camChunk.y - halfHeight, -renderHeight);
+    *maxY = std::min(camChunk.y + halfHeight, renderHeight);
+    return *minY <= *maxY;
+}
+
 std::shared_ptr<Player> World::GetPlayer() const
 {
     return m_Player;
 }
 
+std::shared_ptr<VoxelCache> World::GetVoxelCache() const
+{
+    return voxelCache;
+}
+
+std::shared_ptr<ColumnCache> World::GetColumnCache() const
+{
+    return columnCache;
+}
+
+std::shared_ptr<const WorldGenerator> World::GetWorldGenerator() const
+{
+    return worldGenerator;
+}
+
+std::shared_ptr<ChunkScheduler> World::GetChunkScheduler() const
+{
+    return chunkScheduler;
+}
+
+std::shared_ptr<FChunkJobStats> World::GetChunkJobStats() const
+{
+    return chunkJobStats;
+}
+
+std::shared_ptr<ChunkJobQueue> World::GetCompletedChunkJobs() const
+{
+    return completedChunkJobs;
+}
+
+std::shared_ptr<MeshUploader> World::GetMeshUploader() const
+{
+    return meshUploader;
+}
+
 std::shared_ptr<Chunk> World::GetChunkAtPosition(const glm::vec3& worldPos) const
 {
     // Calculate the chunk coordinates from the world position
@@ -162,19 +437,15 @@ std::shared_ptr<Chunk> World::GetChunkAtPosition(const glm::vec3& worldPos) cons
     int chunkY = static_cast<int>(std::floor(worldPos.y / chunkSize));
     int chunkZ = static_cast<int>(std::floor(worldPos.z / chunkSize));
 
-    // Create a tuple to represent the chunk coordinates
-    std::tuple<int, int, int> chunkCoord(chunkX, chunkY, chunkZ);
-
-    auto it = chunks.find(chunkCoord);
-    if (it != chunks.end())
+    if (const std::shared_ptr<Chunk>* chunk = chunks.Find(glm::ivec3(chunkX, chunkY, chunkZ)))
     {
-        return it->second;
+        return *chunk;
     }
         
     return nullptr; 
 }
 
-uint8_t World::GetBlockAtWorldPosition(const glm::vec3& worldPosition) const
+BlockID World::GetBlockAtWorldPosition(const glm::vec3& worldPosition) const
 {
     // Get the chunk at the given world position
     if (const auto chunk = GetChunkAtPosition(worldPosition))
@@ -186,18 +457,16 @@ uint8_t World::GetBlockAtWorldPosition(const glm::vec3& worldPosition) const
         glm::ivec3 localChunkPos = glm::ivec3(localPos);
 
         // Ensure localChunkPos is within chunk bounds
-        if (localChunkPos.x >= 0 && localChunkPos.x < chunkSize &&
-            localChunkPos.y >= 0 && localChunkPos.y < chunkSize &&
-            localChunkPos.z >= 0 && localChunkPos.z < chunkSize)
+        if (ChunkVolume::Contains(localChunkPos, chunkSize))
         {
             // Get the block at the local position within the chunk
             return chunk->GetBlockAtPosition(localChunkPos);
         }
     }
-    return -1; // Return a default value or handle as needed
+    return InvalidBlock;
 }
 
-uint8_t World::Raycast(const glm::vec3& start, const glm::vec3& end, glm::ivec3& hitBlockPos, float maxDistance)
+BlockID World::Raycast(const glm::vec3& start, const glm::vec3& end, glm::ivec3& hitBlockPos, float maxDistance)
 {
     DrawLine(start, end, glm::vec3(1.0f, 1.0f, 1.0f));
     
@@ -269,9 +538,9 @@ uint8_t World::Raycast(const glm::vec3& start, const glm::vec3& end, glm::ivec3&
             }
         }
 
-        // Step 7: Check if this block is solid (i.e., a block hit)
-        uint8_t blockType = GetBlockAtWorldPosition(currentBlock);
-        if (blockType != 0) {
+        // Step 7: Check if this block is solid (i.e., a block hit); unloaded space is passed through, not hit
+        BlockID blockType = GetBlockAtWorldPosition(currentBlock);
+        if (blockType != 0 && blockType != InvalidBlock) {
             hitBlockPos = currentBlock;
             return blockType;  // Return the block type of the hit block
         }
@@ -1,38 +1,63 @@
 #pragma once
 
-#include <unordered_map>
 #include <string>
-#include <queue>
 #include <glm/glm.hpp>
 
 #include "Chunk.h"
-#include "../TupleHash.h"
+#include "ChunkBuildJob.h"
+#include "ChunkCoord.h"
+#include "ChunkCuller.h"
+#include "ChunkGrid.h"
+#include "ChunkVisibility.h"
 #include "Camera.h"
+#include "../FlatHashMap.h"
+#include "../Renderer/OcclusionBuffer.h"
 
 struct DebugLine;
 struct Block;
 class Player;
+class WorldGenerator;
+class ColumnCache;
+class ChunkScheduler;
+class MeshUploader;
 
 class World
 {
 
 public:
 
-	World(std::string InWorldName);
+	World(std::string InWorldName, int64_t InSeed = 0);
 	~World();
 
 
-	static std::shared_ptr<World> CreateWorld(const std::string& InWorldName);
+	static std::shared_ptr<World> CreateWorld(const std::string& InWorldName, int64_t InSeed = 0);
 
 	
 	void Update(double DeltaTime);
 
 	std::shared_ptr<Player> GetPlayer() const;
+	std::shared_ptr<VoxelCache> GetVoxelCache() const;
+	std::shared_ptr<ColumnCache> GetColumnCache() const;
+	std::shared_ptr<const WorldGenerator> GetWorldGenerator() const;
+	std::shared_ptr<ChunkScheduler> GetChunkScheduler() const;
+	std::shared_ptr<FChunkJobStats> GetChunkJobStats() const;
+	std::shared_ptr<ChunkJobQueue> GetCompletedChunkJobs() const;
+	std::shared_ptr<MeshUploader> GetMeshUploader() const;
+	const ChunkCuller& GetChunkCuller() const { return chunkCuller; }
+	const ChunkVisibilityGraph& GetChunkVisibility() const { return chunkVisibility; }
+	const OcclusionBuffer& GetOcclusionBuffer() const { return occlusionBuffer; }
+
+	EMeshingMode GetMeshingMode() const { return meshingMode; }
+
+	/** Switches how chunk meshes are built and reloads every chunk so they all use the new mode */
+	void SetMeshingMode(EMeshingMode InMeshingMode);
 	
 	std::shared_ptr<Chunk> GetChunkAtPosition(const glm::vec3& worldPos) const;
-	uint8_t GetBlockAtWorldPosition(const glm::vec3& worldPosition) const;
 
-	uint8_t Raycast(const glm::vec3& start, const glm::vec3& end, glm::ivec3& hitBlockPos, float maxDistance = 100.0f);
+	/** InvalidBlock if no built chunk holds worldPosition */
+	BlockID GetBlockAtWorldPosition(const glm::vec3& worldPosition) const;
+
+	BlockID Raycast(const glm::vec3& start, const glm::vec3& end, glm::ivec3& hitBlockPos, float maxDistance = 100.0f);
 
 	void UpdateDebugLines(double deltaTime);
 	void RenderDebugLines();
@@ -43,6 +68,27 @@ public:
 
 	uint32_t numChunks = 0;
 	uint32_t numChunksRendered = 0;
+	uint32_t numChunksCulled = 0;
+	uint32_t numChunksOccluded = 0;
+
+	uint32_t numChunksDepthCulled = 0;
+
+	/** Skip chunks no line of sight through air can reach from the camera's chunk */
+	bool bCaveCulling = true;
+
+	/** Skip chunks hidden behind the solid parts of the chunks in view */
+	bool bOcclusionCulling = true;
+
+private:
+
+	/** Queues chunks that entered the load set and unqueues ones that left it when the camera moves between chunks */
+	void UpdateLoadSet(const glm::ivec3& oldCamChunk, const glm::ivec3& newCamChunk);
+
+	/** The range of chunk y coordinates in column (x, z) that should be loaded around camChunk. False if there is none. */
+	bool GetLoadColumnRange(int x, int z, const glm::ivec3& camChunk, int* minY, int* maxY) const;
+
+	/** Tells the caches a chunk unloaded. Its column is only released once no other loaded chunk stacked in it is left. */
+	void ReleaseChunkCaches(const glm::ivec3& chunkPos);
 
 private:
 
@@ -52,11 +98,56 @@ private:
 	/** Player */
 	std::shared_ptr<Player> m_Player;
 
-	/** All chunks currently in memory */
-	std::unordered_map<std::tuple<int, int, int>, std::shared_ptr<Chunk>> chunks;
+	/** Terrain generator for this world's seed, shared read-only by every generation job */
+	std::shared_ptr<const WorldGenerator> worldGenerator;
+
+	/** Surface height and biome per chunk column, shared by every chunk stacked in the column */
+	std::shared_ptr<ColumnCache> columnCache;
+
+	/** Generated voxel volumes shared by every chunk generation job */
+	std::shared_ptr<VoxelCache> voxelCache;
+
+	/** All chunks currently in memory, in a ring buffer covering render distance around the camera column */
+	TChunkGrid<std::shared_ptr<Chunk>> chunks;
+
+	/** Orders missing chunks around the camera and limits how many generate at once */
+	std::shared_ptr<ChunkScheduler> chunkScheduler;
 
-	/** Chunks awaiting render */
-	std::queue<glm::vec3> chunkQueue;
+	/** Counts of chunk build jobs cancelled after being submitted */
+	std::shared_ptr<FChunkJobStats> chunkJobStats;
+
+	/** Build jobs that finished since the last frame */
+	std::shared_ptr<ChunkJobQueue> completedChunkJobs;
+
+	/** Spreads finished chunk meshes' GPU uploads across frames */
+	std::shared_ptr<MeshUploader> meshUploader;
+
+	/** Finds the chunks hidden behind solid terrain from the camera's chunk */
+	ChunkVisibilityGraph chunkVisibility;
+
+	/** Frustum culls the loaded chunks before they are drawn */
+	ChunkCuller chunkCuller;
+
+	/** Depth buffer of the solid boxes of the chunks in view, tested before each chunk is drawn */
+	OcclusionBuffer occlusionBuffer;
+	std::vector<FOccluderBox> occluderBoxes;
+
+	/** Only chunks this many chunks from the camera draw occluders. Further ones cover few pixels and rarely hide anything the near ones don't. */
+	int occluderDistance = 3;
+
+	/** Mesher new chunk build jobs use */
+	EMeshingMode meshingMode = EMeshingMode::BinaryGreedy;
+
+	/** Loaded chunks in range this frame, with their positions for the culler, and the indices of the visible ones */
+	std::vector<Chunk*> drawCandidates;
+	std::vector<glm::ivec3> drawCandidatePositions;
+	std::vector<uint32_t> visibleChunks;
+
+	/** Loaded chunks per column, keyed with y = 0. Columns with none are not stored. */
+	TFlatHashMap<ChunkCoord, uint32_t> numLoadedChunksPerColumn;
+
+	/** Chunks leaving render distance this frame, erased after the render loop */
+	std::vector<ChunkCoord> chunksToUnload;
 
 	/** Render Distance */
 	int renderDistance = 6;
@@ -67,13 +158,16 @@ private:
 	/** How large the chunk is as 3x3 */
 	uint8_t chunkSize = 32;
 
-	/** Number of chunks currently loading */
-	uint32_t chunksLoading = 0;
-
 	/** Currently rendered debug lines */
 	std::vector<DebugLine> debugLines;
 	unsigned int lineVAO, lineVBO;
 
 	
 	int lastCamX = -100, lastCamY = -100, lastCamZ = -100;
+
+	/** Indexed by column offset from the camera chunk, see GetLoadColumnRange */
+	std::vector<int> loadColumnHalfHeights;
+
+	/** False until the first load set is queued, so there is no previous camera position to diff against */
+	bool bHasLoadSet = false;
 };
@@ -1,8 +0,0 @@
-#pragma once
-
-#include <vector>
-
-namespace WorldGen
-{
-	void GenerateChunkData(int chunkX, int chunkY, int chunkZ, int chunkSize, std::vector<uint8_t>* chunkData);
-}
\ No newline at end of file
@@ -0,0 +1,412 @@
+#include "WorldGenerator.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "ChunkVolume.h"
+
+// SplitMix64 finaliser, used to derive an independent seed for each noise layer
+static int64_t DeriveSeed(int64_t seed, uint64_t layer)
+{
+    uint64_t z = static_cast<uint64_t>(seed) + (layer + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<int64_t>(z ^ (z >> 31));
+}
+
+// Floor division that rounds towards negative infinity, so lattice cells line up across the origin
+static int FloorDiv(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+WorldGenerator::WorldGenerator(int64_t InSeed, int InCaveStride)
+    : Seed(InSeed), CaveStride(InCaveStride > 1 ? InCaveStride : 1),
+      SurfaceNoise(DeriveSeed(InSeed, 0)), BiomeNoise(DeriveSeed(InSeed, 1)), CaveNoise(DeriveSeed(InSeed, 2))
+{
+}
+
+WorldGenerator::~WorldGenerator()
+{
+}
+
+void WorldGenerator::GenerateColumn(int chunkX, int chunkZ, int chunkSize, FColumnData* columnData) const
+{
+    columnData->SurfaceHeight.resize(chunkSize * chunkSize);
+    columnData->Biome.resize(chunkSize * chunkSize);
+
+    int startX = chunkX * chunkSize;
+    int startZ = chunkZ * chunkSize;
+
+    // Noise is evaluated one row of z at a time through the batched path
+    thread_local std::vector<float> surfaceX, surfaceZ, biomeX, biomeZ, surfaceValues, biomeValues;
+    for (std::vector<float>* row : { &surfaceX, &surfaceZ, &biomeX, &biomeZ, &surfaceValues, &biomeValues })
+    {
+        row->resize(chunkSize);
+    }
+
+    for (int z = 0; z < chunkSize; z++)
+    {
+        surfaceZ[z] = (float)(z + startZ) * 0.03f;
+        biomeZ[z] = (float)(z + startZ) * 0.2f;
+    }
+
+    for (int x = 0; x < chunkSize; x++)
+    {
+        std::fill(surfaceX.begin(), surfaceX.end(), (float)(x + startX) / 32);
+        std::fill(biomeX.begin(), biomeX.end(), (float)(x + startX) * 0.1f);
+
+        SurfaceNoise.EvalBatch(surfaceX.data(), surfaceZ.data(), surfaceValues.data(), chunkSize);
+        BiomeNoise.EvalBatch(biomeX.data(), biomeZ.data(), biomeValues.data(), chunkSize);
+
+        for (int z = 0; z < chunkSize; z++)
+        {
+            // Height calculation
+            float surfaceNoiseValue = surfaceValues[z];
+
+            int noiseY = static_cast<int>((surfaceNoiseValue + 1.0f) * 0.5f * 10.0f + 32.0f);
+
+            // Biome noise
+            float biomeNoiseValue = biomeValues[z];
+            int biomeType = biomeNoiseValue > 0.0f ? 1 : 0; // Simple biome switch
+
+            columnData->SurfaceHeight[x * chunkSize + z] = noiseY;
+            columnData->Biome[x * chunkSize + z] = static_cast<uint8_t>(biomeType);
+        }
+    }
+
+    const auto [minHeight, maxHeight] = std::minmax_element(columnData->SurfaceHeight.begin(), columnData->SurfaceHeight.end());
+    columnData->MinSurfaceHeight = *minHeight;
+    columnData->MaxSurfaceHeight = *maxHeight;
+}
+
+bool WorldGenerator::FindUniformBlock(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, BlockID* block) const
+{
+    const int startY = chunkY * chunkSize;
+    const int endY = startY + chunkSize - 1;
+
+    // Everything above the surface is air, caves or not
+    if (startY > columnData.MaxSurfaceHeight)
+    {
+        *block = (BlockID)Block::EBlockType::AIR;
+        return true;
+    }
+
+    // Below the dirt band every voxel is stone unless a cave carves it. The exact path has no cheap bound on the noise.
+    if (endY > columnData.MinSurfaceHeight - 5 || CaveStride == 1)
+    {
+        return false;
+    }
+
+    // Trilinear interpolation never exceeds the largest lattice sample of its cell. The margin covers rounding in glm::mix.
+    const glm::ivec3 worldMin(chunkX * chunkSize, startY, chunkZ * chunkSize);
+    glm::ivec3 latticeMin, latticeMax;
+    GetCaveLatticeBounds(worldMin, glm::ivec3(chunkSize), &latticeMin, &latticeMax);
+
+    const glm::ivec3 latticeSize = latticeMax - latticeMin + 1;
+    thread_local std::vector<float> samples;
+    samples.resize(static_cast<size_t>(latticeSize.x) * latticeSize.y * latticeSize.z);
+    SampleCaveLattice(latticeMin, latticeMax, samples.data());
+
+    if (*std::max_element(samples.begin(), samples.end()) > 0.5f - 1e-4f)
+    {
+        return false;
+    }
+
+    *block = (BlockID)Block::EBlockType::STONE;
+    return true;
+}
+
+void WorldGenerator::GenerateChunkData(int chunkX, int chunkY, int chunkZ, int chunkSize, std::vector<BlockID>* chunkData) const
+{
+    FColumnData columnData;
+    GenerateColumn(chunkX, chunkZ, chunkSize, &columnData);
+
+    GenerateChunkData(chunkX, chunkY, chunkZ, chunkSize, columnData, chunkData);
+}
+
+void WorldGenerator::GenerateChunkData(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, std::vector<BlockID>* chunkData) const
+{
+    // A full region is already in (x, z, y) order, which is the column layout
+    if constexpr (ChunkVolume::Layout == EVoxelLayout::YColumn)
+    {
+        GenerateChunkRegion(chunkX, chunkY, chunkZ, chunkSize, columnData, glm::ivec3(0), glm::ivec3(chunkSize), chunkData);
+        return;
+    }
+
+    thread_local std::vector<BlockID> regionData;
+    GenerateChunkRegion(chunkX, chunkY, chunkZ, chunkSize, columnData, glm::ivec3(0), glm::ivec3(chunkSize), &regionData);
+
+    chunkData->resize(regionData.size());
+
+    const BlockID* block = regionData.data();
+    for (int x = 0; x < chunkSize; x++)
+    {
+        for (int z = 0; z < chunkSize; z++)
+        {
+            for (int y = 0; y < chunkSize; y++)
+            {
+                (*chunkData)[ChunkVolume::Index(x, y, z, chunkSize)] = *block++;
+            }
+        }
+    }
+}
+
+void WorldGenerator::GenerateChunkRegion(int chunkX, int chunkY, int chunkZ, int chunkSize, const glm::ivec3& regionMin, const glm::ivec3& regionMax, std::vector<BlockID>* regionData) const
+{
+    FColumnData columnData;
+    GenerateColumn(chunkX, chunkZ, chunkSize, &columnData);
+
+    GenerateChunkRegion(chunkX, chunkY, chunkZ, chunkSize, columnData, regionMin, regionMax, regionData);
+}
+
+void WorldGenerator::GenerateChunkRegion(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, const glm::ivec3& regionMin, const glm::ivec3& regionMax, std::vector<BlockID>* regionData) const
+{
+    const glm::ivec3 regionSize = regionMax - regionMin;
+    regionData->resize(static_cast<size_t>(regionSize.x) * regionSize.y * regionSize.z);
+
+    int startX = chunkX * chunkSize;
+    int startY = chunkY * chunkSize;
+    int startZ = chunkZ * chunkSize;
+
+    // Reused across calls on the same worker thread
+    thread_local std::vector<float> caveDensity;
+    caveDensity.resize(regionData->size());
+    FillCaveDensity(glm::ivec3(startX, startY, startZ) + regionMin, regionSize, caveDensity.data());
+
+    BlockID* out = regionData->data();
+    const float* density = caveDensity.data();
+
+    for (int x = regionMin.x; x < regionMax.x; x++)
+    {
+        for (int z = regionMin.z; z < regionMax.z; z++)
+        {
+            const int noiseY = columnData.SurfaceHeight[x * chunkSize + z];
+            const int biomeType = columnData.Biome[x * chunkSize + z];
+
+            for (int y = regionMin.y; y < regionMax.y; y++)
+            {
+                float caveNoiseValue = *density++;
+
+                if (y + startY > noiseY || caveNoiseValue > 0.5f)
+                {
+                    *out++ = (BlockID)Block::EBlockType::AIR;
+                }
+                else if (y + startY == noiseY)
+                {
+                    *out++ = (BlockID)Block::EBlockType::GRASS;
+                }
+                else if (y + startY > noiseY - 5)
+                {
+                    *out++ = biomeType == 0 ? (BlockID)Block::EBlockType::GRASS : (BlockID)Block::EBlockType::DIRT;
+                }
+                else
+                {
+                    *out++ = (BlockID)Block::EBlockType::STONE;
+                }
+            }
+        }
+    }
+}
+
+void WorldGenerator::GenerateChunkSlab(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, int axis, int layer, std::vector<BlockID>* slabData) const
+{
+    glm::ivec3 regionMin(0);
+    glm::ivec3 regionMax(chunkSize);
+
+    regionMin[axis] = layer;
+    regionMax[axis] = layer + 1;
+
+    // A one-voxel-thick box in (x, z, y) order is already the documented slab layout
+    GenerateChunkRegion(chunkX, chunkY, chunkZ, chunkSize, columnData, regionMin, regionMax, slabData);
+}
+
+void WorldGenerator::FillCaveDensity(const glm::ivec3& worldMin, const glm::ivec3& size, float* density) const
+{
+    if (CaveStride == 1)
+    {
+        // Coordinates of one y column, evaluated as a single batch
+        thread_local std::vector<float> columnX, columnY, columnZ;
+        columnX.resize(size.y);
+        columnY.resize(size.y);
+        columnZ.resize(size.y);
+
+        for (int y = 0; y < size.y; y++)
+        {
+            columnY[y] = static_cast<float>(worldMin.y + y) * 0.1f;
+        }
+
+        for (int x = 0; x < size.x; x++)
+        {
+            for (int z = 0; z < size.z; z++)
+            {
+                std::fill(columnX.begin(), columnX.end(), static_cast<float>(worldMin.x + x) * 0.1f);
+                std::fill(columnZ.begin(), columnZ.end(), static_cast<float>(worldMin.z + z) * 0.1f);
+
+                CaveNoise.EvalBatch(columnX.data(), columnY.data(), columnZ.data(), density, size.y);
+                density += size.y;
+            }
+        }
+        return;
+    }
+
+    glm::ivec3 latticeMin, latticeMax;
+    GetCaveLatticeBounds(worldMin, size, &latticeMin, &latticeMax);
+    const glm::ivec3 latticeSize = latticeMax - latticeMin + 1;
+
+    // Sample the noise at lattice points; each sample is the exact value the per-voxel path would produce there
+    thread_local std::vector<float> samples;
+    samples.resize(static_cast<size_t>(latticeSize.x) * latticeSize.y * latticeSize.z);
+    SampleCaveLattice(latticeMin, latticeMax, samples.data());
+
+    // Lattice cell and interpolation weight of every voxel along each axis
+    thread_local std::vector<int> cells[3];
+    thread_local std::vector<float> weights[3];
+    for (int axis = 0; axis < 3; axis++)
+    {
+        cells[axis].resize(size[axis]);
+        weights[axis].resize(size[axis]);
+
+        for (int i = 0; i < size[axis]; i++)
+        {
+            const int voxel = worldMin[axis] + i;
+            const int cell = FloorDiv(voxel, CaveStride);
+
+            cells[axis][i] = cell - latticeMin[axis];
+            weights[axis][i] = static_cast<float>(voxel - cell * CaveStride) / static_cast<float>(CaveStride);
+        }
+    }
+
+    const int strideZ = latticeSize.y;
+    const int strideX = latticeSize.z * latticeSize.y;
+
+    for (int x = 0; x < size.x; x++)
+    {
+        const float tx = weights[0][x];
+
+        for (int z = 0; z < size.z; z++)
+        {
+            const float tz = weights[2][z];
+            const float* base = samples.data() + cells[0][x] * strideX + cells[2][z] * strideZ;
+
+            for (int y = 0; y < size.y; y++)
+            {
+                const float ty = weights[1][y];
+                const float* corner = base + cells[1][y];
+
+                const float c00 = glm::mix(corner[0],           corner[strideX],               tx);
+                const float c01 = glm::mix(corner[1],           corner[strideX + 1],           tx);
+                const float c10 = glm::mix(corner[strideZ],     corner[strideX + strideZ],     tx);
+                const float c11 = glm::mix(corner[strideZ + 1], corner[strideX + strideZ + 1], tx);
+
+                const float c0 = glm::mix(c00, c10, tz);
+                const float c1 = glm::mix(c01, c11, tz);
+
+                *density++ = glm::mix(c0, c1, ty);
+            }
+        }
+    }
+}
+
+void WorldGenerator::GetCaveLatticeBounds(const glm::ivec3& worldMin, const glm::ivec3& size, glm::ivec3* latticeMin, glm::ivec3* latticeMax) const
+{
+    const glm::ivec3 worldMax = worldMin + size - 1;
+
+    *latticeMin = glm::ivec3(FloorDiv(worldMin.x, CaveStride), FloorDiv(worldMin.y, CaveStride), FloorDiv(worldMin.z, CaveStride));
+    *latticeMax = glm::ivec3(FloorDiv(worldMax.x, CaveStride) + 1, FloorDiv(worldMax.y, CaveStride) + 1, FloorDiv(worldMax.z, CaveStride) + 1);
+}
+
+void WorldGenerator::SampleCaveLattice(const glm::ivec3& latticeMin, const glm::ivec3& latticeMax, float* samples) const
+{
+    const int sizeY = latticeMax.y - latticeMin.y + 1;
+
+    // Coordinates of one y column, evaluated as a single batch
+    thread_local std::vector<float> columnX, columnY, columnZ;
+    columnX.resize(sizeY);
+    columnY.resize(sizeY);
+    columnZ.resize(sizeY);
+
+    for (int y = 0; y < sizeY; y++)
+    {
+        columnY[y] = static_cast<float>((latticeMin.y + y) * CaveStride) * 0.1f;
+    }
+
+    for (int x = latticeMin.x; x <= latticeMax.x; x++)
+    {
+        for (int z = latticeMin.z; z <= latticeMax.z; z++)
+        {
+            std::fill(columnX.begin(), columnX.end(), static_cast<float>(x * CaveStride) * 0.1f);
+            std::fill(columnZ.begin(), columnZ.end(), static_cast<float>(z * CaveStride) * 0.1f);
+
+            CaveNoise.EvalBatch(columnX.data(), columnY.data(), columnZ.data(), samples, sizeY);
+            samples += sizeY;
+        }
+    }
+}
+
+uint64_t WorldGenerator::HashRegion(const glm::ivec3& minChunk, const glm::ivec3& maxChunk, int chunkSize) const
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    std::vector<BlockID> chunkData;
+
+    for (int x = minChunk.x; x <= maxChunk.x; x++)
+    {
+        for (int y = minChunk.y; y <= maxChunk.y; y++)
+        {
+            for (int z = minChunk.z; z <= maxChunk.z; z++)
+            {
+                GenerateChunkData(x, y, z, chunkSize, &chunkData);
+
+                // Hashed in (x, z, y) order so the golden hash does not depend on the storage layout
+                for (int localX = 0; localX < chunkSize; localX++)
+                {
+                    for (int localZ = 0; localZ < chunkSize; localZ++)
+                    {
+                        for (int localY = 0; localY < chunkSize; localY++)
+                        {
+                            hash ^= chunkData[ChunkVolume::Index(localX, localY, localZ, chunkSize)];
+                            hash *= 0x100000001B3ULL;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return hash;
+}
+
+float WorldGenerator::MeasureMismatch(const WorldGenerator& reference, const glm::ivec3& minChunk, const glm::ivec3& maxChunk, int chunkSize) const
+{
+    uint64_t mismatched = 0;
+    uint64_t total = 0;
+    std::vector<BlockID> chunkData, referenceData;
+
+    for (int x = minChunk.x; x <= maxChunk.x; x++)
+    {
+        for (int y = minChunk.y; y <= maxChunk.y; y++)
+        {
+            for (int z = minChunk.z; z <= maxChunk.z; z++)
+            {
+                GenerateChunkData(x, y, z, chunkSize, &chunkData);
+                reference.GenerateChunkData(x, y, z, chunkSize, &referenceData);
+
+                for (size_t i = 0; i < chunkData.size(); i++)
+                {
+                    mismatched += chunkData[i] != referenceData[i];
+                }
+                total += chunkData.size();
+            }
+        }
+    }
+
+    return total > 0 ? static_cast<float>(mismatched) / static_cast<float>(total) : 0.0f;
+}
+
+bool WorldGenerator::VerifyDeterminism()
+{
+    return WorldGenerator(0).HashRegion({ -1, 0, -1 }, { 1, 1, 1 }, 32) == GoldenRegionHash;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "Noise.h"
+
+/** Surface height and biome of every voxel column in one chunk column, shared by all chunks stacked in it */
+struct FColumnData
+{
+	/** World-space y of the surface block, indexed x * chunkSize + z */
+	std::vector<int32_t> SurfaceHeight;
+
+	/** Biome type, indexed x * chunkSize + z */
+	std::vector<uint8_t> Biome;
+
+	/** Bounds of SurfaceHeight, used to prove chunks above or far below the surface uniform without generating them */
+	int32_t MinSurfaceHeight = 0;
+	int32_t MaxSurfaceHeight = 0;
+};
+
+/**
+ * Seeded terrain generator. Noise permutation tables are built once on construction and only read afterwards,
+ * so a single instance is shared by every generation job.
+ *
+ * Output is deterministic: a given seed and chunk coordinate always produce the same bytes.
+ */
+class WorldGenerator
+{
+public:
+
+	/**
+	 * @param InCaveStride	Spacing in voxels of the cave density lattice. Cave noise is sampled on the lattice and
+	 *						trilinearly interpolated in between; 1 evaluates it exactly at every voxel.
+	 */
+	WorldGenerator(int64_t InSeed, int InCaveStride = DefaultCaveStride);
+	~WorldGenerator();
+
+	/** Evaluates the 2D surface and biome noise for a chunk column. Every chunkY in the column shares the result. */
+	void GenerateColumn(int chunkX, int chunkZ, int chunkSize, FColumnData* columnData) const;
+
+	/** Generates a full chunk volume, indexed through ChunkVolume */
+	void GenerateChunkData(int chunkX, int chunkY, int chunkZ, int chunkSize, std::vector<BlockID>* chunkData) const;
+	void GenerateChunkData(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, std::vector<BlockID>* chunkData) const;
+
+	/**
+	 * Generates the sub-box [regionMin, regionMax) of a chunk, in chunk-local voxel coordinates.
+	 * Output is always x-major, then z, then y, whatever ChunkVolume's layout is.
+	 */
+	void GenerateChunkRegion(int chunkX, int chunkY, int chunkZ, int chunkSize, const glm::ivec3& regionMin, const glm::ivec3& regionMax, std::vector<BlockID>* regionData) const;
+	void GenerateChunkRegion(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, const glm::ivec3& regionMin, const glm::ivec3& regionMax, std::vector<BlockID>* regionData) const;
+
+	/**
+	 * Generates the single chunkSize x chunkSize layer of a chunk at the given local index along an axis (0 = x, 1 = y, 2 = z).
+	 * The two remaining axes are stored in (x, z, y) priority order, e.g. index = x * chunkSize + z for a y slab.
+	 */
+	void GenerateChunkSlab(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, int axis, int layer, std::vector<BlockID>* slabData) const;
+
+	/**
+	 * Returns true if every voxel of the chunk is provably the same block, without generating it.
+	 * Chunks above the column's highest surface are air; chunks entirely in the stone band whose cave density lattice
+	 * stays below the carving threshold are stone. May return false for chunks that still turn out uniform.
+	 */
+	bool FindUniformBlock(int chunkX, int chunkY, int chunkZ, int chunkSize, const FColumnData& columnData, BlockID* block) const;
+
+	/** FNV-1a hash of every chunk volume in the inclusive chunk range [minChunk, maxChunk] */
+	uint64_t HashRegion(const glm::ivec3& minChunk, const glm::ivec3& maxChunk, int chunkSize) const;
+
+	/** Fraction of voxels in the inclusive chunk range [minChunk, maxChunk] that differ from another generator's output */
+	float MeasureMismatch(const WorldGenerator& reference, const glm::ivec3& minChunk, const glm::ivec3& maxChunk, int chunkSize) const;
+
+	/** Regenerates the golden region for seed 0 and checks it against GoldenRegionHash */
+	static bool VerifyDeterminism();
+
+	int64_t GetSeed() const { return Seed; }
+	int GetCaveStride() const { return CaveStride; }
+
+public:
+
+	static constexpr int DefaultCaveStride = 4;
+
+	/** HashRegion({-1, 0, -1}, {1, 1, 1}, 32) for seed 0 and the default cave stride. Update deliberately whenever terrain output is meant to change. */
+	static constexpr uint64_t GoldenRegionHash = 0x74A3283AA4ACC8F9ULL;
+
+private:
+
+	/**
+	 * Writes the cave noise value of every voxel in the world-space box [worldMin, worldMin + size), in (x, z, y) order.
+	 * Lattice points are aligned to world multiples of CaveStride, so any sub-box agrees with the full chunk.
+	 */
+	void FillCaveDensity(const glm::ivec3& worldMin, const glm::ivec3& size, float* density) const;
+
+	/** Inclusive range of lattice points whose cells cover the world-space box [worldMin, worldMin + size) */
+	void GetCaveLatticeBounds(const glm::ivec3& worldMin, const glm::ivec3& size, glm::ivec3* latticeMin, glm::ivec3* latticeMax) const;
+
+	/** Writes the cave noise at every lattice point in [latticeMin, latticeMax], in (x, z, y) order */
+	void SampleCaveLattice(const glm::ivec3& latticeMin, const glm::ivec3& latticeMax, float* samples) const;
+
+private:
+
+	int64_t Seed;
+	int CaveStride;
+
+	Noise2D SurfaceNoise;
+	Noise2D BiomeNoise;
+	Noise3D CaveNoise;
+};